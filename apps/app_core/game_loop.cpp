@@ -1,5 +1,6 @@
 #include "game_loop.hpp"
 #include "apps/interface/game.hpp"
+#include <chrono>
 
 namespace folio::app
 {
@@ -7,8 +8,14 @@ void GameLoop::run(Game &game, const TickRates &rates)
 {
     AppContext ctx{};
     ctx.window = &window_;
+    ctx.jobs = &jobs_;
     game.init(ctx);
 
+    auto &frame_us = metrics::histogram("frame.time_us");
+    auto &frame_steps = metrics::histogram("frame.fixed_steps");
+    auto &render_us = metrics::histogram("frame.render_us");
+    auto &pending = metrics::gauge("jobs.pending");
+
     sf::Clock clock;
     float acc = 0.f;
 
@@ -35,12 +42,72 @@ void GameLoop::run(Game &game, const TickRates &rates)
             ++steps;
         }
 
+        frame_us.record(std::uint64_t(frame * 1e6f));
+        frame_steps.record(std::uint64_t(steps));
+
         game.frameUpdate(ctx, frame);
+        runBackground(ctx, rates, clock.getElapsedTime().asSeconds());
+        pending.set(std::int64_t(jobs_.pending()));
+
+        const float render_start = clock.getElapsedTime().asSeconds();
         game.render(ctx);
+        ctx.frame.render_sec = clock.getElapsedTime().asSeconds() - render_start;
+        render_us.record(std::uint64_t(ctx.frame.render_sec * 1e6f));
         window_.display();
+
+        if (metrics_dump_)
+        {
+            metrics_dump_->tick(frame);
+        }
+    }
+
+    game.shutdown(ctx);
+    if (metrics_dump_)
+    {
+        metrics_dump_->flush();
+    }
+}
+
+void GameLoop::runBackground(AppContext &ctx, const TickRates &rates, float frame_elapsed)
+{
+    // headroom = 목표 프레임 - (이번 프레임 시뮬레이션) - (직전 프레임 렌더) - 여유
+    const double headroom = double(rates.target_frame) - frame_elapsed - ctx.frame.render_sec - rates.frame_reserve;
+    ctx.frame.budget_sec = headroom;
+    if (headroom > 0.0)
+    {
+        ctx.frame.background = jobs_.drain(headroom);
+    }
+    else
+    {
+        // 여유가 없으면 보이는 작업만 하나씩 진행시켜 굶지 않게 함
+        ctx.frame.background = jobs_.drain(1e-9, concurrency::Priority::Visible);
+    }
+}
+
+double runHeadless(Game &game, size_t steps, const TickRates &rates, size_t workers)
+{
+    using clock = std::chrono::steady_clock;
+    concurrency::JobSystem jobs(workers > 0 ? workers : concurrency::defaultWorkerCount());
+    AppContext ctx{};
+    ctx.jobs = &jobs;
+    game.init(ctx);
+
+    auto &tick_us = metrics::histogram("tick.time_us");
+    auto &pending = metrics::gauge("jobs.pending");
+    double sim = 0.0;
+    for (size_t i = 0; i < steps; ++i)
+    {
+        const auto start = clock::now();
+        game.fixedUpdate(ctx, rates.fixed_delta);
+        const double sec = std::chrono::duration<double>(clock::now() - start).count();
+        sim += sec;
+        tick_us.record(std::uint64_t(sec * 1e6));
+        pending.set(std::int64_t(jobs.pending()));
+        ctx.frame.background = jobs.drain();
     }
 
     game.shutdown(ctx);
+    return sim;
 }
 ; // NOLINT
 } // namespace folio::app
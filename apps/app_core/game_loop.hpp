@@ -1,9 +1,12 @@
 #pragma once
 
 #include "apps/interface/game.hpp"
+#include "src/concurrency/job_system.hpp"
+#include "src/metrics/metrics.hpp"
 #include <SFML/Graphics.hpp>
 #include <SFML/Graphics/RenderWindow.hpp>
 #include <SFML/Window/VideoMode.hpp>
+#include <memory>
 
 namespace folio::app
 {
@@ -11,17 +14,33 @@ class GameLoop
 {
 public:
     explicit GameLoop(const Config &cfg)
-        : window_(sf::VideoMode(sf::Vector2u{static_cast<unsigned>(cfg.width), static_cast<unsigned>(cfg.height)}), cfg.title)
+        : window_(sf::VideoMode(sf::Vector2u{static_cast<unsigned>(cfg.width), static_cast<unsigned>(cfg.height)}), cfg.title),
+          jobs_(cfg.workers > 0 ? size_t(cfg.workers) : concurrency::defaultWorkerCount())
     {
         window_.setFramerateLimit(cfg.frame_rate_limit);
         window_.setVerticalSyncEnabled(cfg.vsync);
+        if (!cfg.metrics_path.empty())
+        {
+            metrics_dump_ = std::make_unique<metrics::PeriodicDump>(cfg.metrics_path, cfg.metrics_interval);
+        }
     }
 
     sf::RenderWindow &window() { return window_; };
+    concurrency::JobSystem &jobs() { return jobs_; }
     void run(Game &game, const TickRates &rates = {});
 
+private:
+    // 목표 프레임 시간에서 남은 만큼 지연 작업을 실행
+    void runBackground(AppContext &ctx, const TickRates &rates, float frame_elapsed);
+
 private:
     sf::RenderWindow window_{};
+    concurrency::JobSystem jobs_;
+    std::unique_ptr<metrics::PeriodicDump> metrics_dump_{};
 };
 
+// 창 없이 fixed step만 steps번 돌림 (재생/벤치마크용). 지연 작업은 매 step 끝에 모두 실행
+// 반환값: fixedUpdate에 걸린 총 시간(초). tick별 시간은 지표 "tick.time_us"에 기록
+double runHeadless(Game &game, size_t steps, const TickRates &rates = {}, size_t workers = 0);
+
 } // namespace folio::app
@@ -0,0 +1,238 @@
+// Tile raycast check and benchmark for collision::raycast (headless, no window)
+//   folio_bench_raycast [WORKERS]    exits non-zero when a ray disagrees with a plain per-tile DDA
+// Random rays over three random 512x512 maps (open field, rooms, caves) are checked against a plain DDA
+// that steps one tile at a time. The only disagreement allowed is a ray through an exact tile corner,
+// where the two traversals may break the tie differently.
+// Bench: rays/ms with the empty chunk/block skip, without it (same walls, occupancy that reports
+// nothing empty) and as one batch on the job system.
+#include "src/collision/raycast.hpp"
+#include "src/concurrency/job_system.hpp"
+#include "src/world/occupancy.hpp"
+#include "src/world/tile_map.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <random>
+#include <vector>
+
+namespace
+{
+using folio::collision::Ray;
+using folio::collision::RayHit;
+using folio::geometry::Vec2;
+using folio::world::TileMap;
+using folio::world::TileOccupancy;
+using Clock = std::chrono::steady_clock;
+
+constexpr int kSize = 512;
+constexpr int kTile = 16;
+constexpr int kCheckRays = 200000;
+constexpr int kBenchRays = 100000;
+constexpr float kTieEps = 1e-3f; // world units: boundary t values closer than this count as a corner tie
+
+TileMap makeMap(const char *id, std::uint32_t seed, int rects, float noise)
+{
+    TileMap map{};
+    map.id = id;
+    map.tile_size = kTile;
+    map.w = map.h = kSize;
+    map.tiles.assign(size_t(kSize) * kSize, 0);
+    std::mt19937 rng{seed};
+    // wall rectangles (rooms, pillars) leave whole chunks and blocks empty in between
+    for (int r = 0; r < rects; ++r)
+    {
+        const int x0 = int(rng() % kSize), y0 = int(rng() % kSize);
+        const int x1 = std::min(kSize, x0 + 1 + int(rng() % 24)), y1 = std::min(kSize, y0 + 1 + int(rng() % 24));
+        const bool hollow = rng() % 2 == 0;
+        for (int y = y0; y < y1; ++y)
+        {
+            for (int x = x0; x < x1; ++x)
+            {
+                const bool edge = x == x0 || y == y0 || x == x1 - 1 || y == y1 - 1;
+                map.tiles[size_t(y) * kSize + x] = !hollow || edge ? 1 : 0;
+            }
+        }
+    }
+    std::uniform_real_distribution<float> unit(0.f, 1.f);
+    for (int &t : map.tiles)
+    {
+        t = unit(rng) < noise ? 1 : t;
+    }
+    return map;
+}
+
+// one tile per step, no occupancy. tie: a step where both boundaries were (almost) equal
+RayHit plainDDA(const TileMap &map, const Ray &ray, bool &tie)
+{
+    RayHit out{};
+    out.dist = ray.max_dist;
+    tie = false;
+    const Vec2 d = folio::geometry::norm(ray.dir);
+    const Vec2 o = ray.origin;
+    const float ts = float(map.tile_size);
+    constexpr float kInf = std::numeric_limits<float>::infinity();
+    int tx = int(std::floor(o.x / ts));
+    int ty = int(std::floor(o.y / ts));
+    if (map.isWall(tx, ty))
+    {
+        return RayHit{true, tx, ty, 0.f, o, Vec2{0.f, 0.f}};
+    }
+    if (d.x == 0.f && d.y == 0.f)
+    {
+        out.point = o;
+        return out;
+    }
+    const int sx = d.x > 0.f ? 1 : (d.x < 0.f ? -1 : 0);
+    const int sy = d.y > 0.f ? 1 : (d.y < 0.f ? -1 : 0);
+    const auto boundary = [&](int i, int s, float origin, float dir) {
+        return s == 0 ? kInf : (float(i + (s > 0 ? 1 : 0)) * ts - origin) / dir;
+    };
+    for (;;)
+    {
+        const float tmx = boundary(tx, sx, o.x, d.x);
+        const float tmy = boundary(ty, sy, o.y, d.y);
+        tie = tie || std::abs(tmx - tmy) < kTieEps;
+        const bool step_x = tmx < tmy;
+        const float t = step_x ? tmx : tmy;
+        (step_x ? tx : ty) += step_x ? sx : sy;
+        if (t > ray.max_dist)
+        {
+            out.point = o + d * ray.max_dist;
+            return out;
+        }
+        if (map.isWall(tx, ty))
+        {
+            out.hit = true;
+            out.tx = tx;
+            out.ty = ty;
+            out.dist = t;
+            out.point = o + d * t;
+            out.normal = step_x ? Vec2{float(-sx), 0.f} : Vec2{0.f, float(-sy)};
+            return out;
+        }
+    }
+}
+
+std::vector<Ray> makeRays(int count, std::uint32_t seed)
+{
+    std::mt19937 rng{seed};
+    std::uniform_real_distribution<float> pos(0.f, float(kSize * kTile));
+    std::uniform_real_distribution<float> ang(0.f, 6.2831853f);
+    std::uniform_real_distribution<float> len(0.f, 64.f * kTile);
+    std::vector<Ray> rays(size_t(count), Ray{});
+    for (int i = 0; i < count; ++i)
+    {
+        Ray &r = rays[size_t(i)];
+        r.origin = {pos(rng), pos(rng)};
+        r.max_dist = len(rng);
+        // every 16th ray is axis aligned, the next one runs diagonally through tile corners, the rest point anywhere
+        if (i % 16 == 0)
+        {
+            const int a = int(rng() % 4);
+            r.dir = {float((a == 0) - (a == 2)), float((a == 1) - (a == 3))};
+        }
+        else if (i % 16 == 1)
+        {
+            r.origin = {(std::floor(r.origin.x / kTile) + 0.5f) * kTile, (std::floor(r.origin.y / kTile) + 0.5f) * kTile};
+            r.dir = {rng() % 2 ? 1.f : -1.f, rng() % 2 ? 1.f : -1.f};
+        }
+        else
+        {
+            const float a = ang(rng);
+            r.dir = {std::cos(a), std::sin(a)};
+        }
+    }
+    return rays;
+}
+
+bool sameHit(const RayHit &a, const RayHit &b)
+{
+    return a.hit == b.hit && (!a.hit || (a.tx == b.tx && a.ty == b.ty && a.normal.x == b.normal.x &&
+                                         a.normal.y == b.normal.y && std::abs(a.dist - b.dist) < 1e-2f));
+}
+
+// best of three runs
+template <typename Cast>
+double raysPerMs(size_t rays, Cast &&cast)
+{
+    double best = 0.0;
+    for (int run = 0; run < 3; ++run)
+    {
+        const auto start = Clock::now();
+        cast();
+        best = std::max(best, rays / std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+    }
+    return best;
+}
+} // namespace
+
+int main(int argc, char **argv)
+{
+    const size_t workers = argc > 1 ? size_t(std::strtoul(argv[1], nullptr, 10)) : folio::concurrency::defaultWorkerCount();
+    folio::concurrency::JobSystem jobs(workers);
+
+    struct Case
+    {
+        const char *name;
+        int rects;
+        float noise;
+    };
+    int failures = 0;
+    std::uint32_t seed = 11;
+    for (const Case &c : {Case{"open", 60, 0.f}, Case{"rooms", 900, 0.002f}, Case{"caves", 0, 0.2f}})
+    {
+        const TileMap map = makeMap(c.name, seed++, c.rects, c.noise);
+        const TileOccupancy occ(map);
+        // the same size, all walls: nothing is ever empty, so the raycast steps tile by tile
+        TileMap full = map;
+        full.tiles.assign(full.tiles.size(), 1);
+        const TileOccupancy no_skip(full);
+
+        const std::vector<Ray> rays = makeRays(kCheckRays, seed++);
+        std::vector<RayHit> hits(rays.size());
+        folio::collision::raycast(map, occ, rays, hits);
+        int ties = 0, hit_count = 0;
+        for (size_t i = 0; i < rays.size(); ++i)
+        {
+            bool tie = false;
+            const RayHit ref = plainDDA(map, rays[i], tie);
+            hit_count += ref.hit ? 1 : 0;
+            if (sameHit(hits[i], ref))
+            {
+                continue;
+            }
+            if (tie)
+            {
+                ++ties;
+                continue;
+            }
+            if (++failures <= 10)
+            {
+                const Ray &r = rays[i];
+                std::fprintf(stderr, "FAIL %s ray %zu: origin (%.3f, %.3f) dir (%.6f, %.6f) max %.1f: "
+                                     "hit %d tile (%d, %d) dist %.3f, plain DDA hit %d tile (%d, %d) dist %.3f\n",
+                             c.name, i, r.origin.x, r.origin.y, r.dir.x, r.dir.y, r.max_dist, hits[i].hit,
+                             hits[i].tx, hits[i].ty, hits[i].dist, ref.hit, ref.tx, ref.ty, ref.dist);
+            }
+        }
+
+        const std::vector<Ray> bench = makeRays(kBenchRays, seed++);
+        std::vector<RayHit> out(bench.size());
+        const double skip = raysPerMs(bench.size(), [&]() { folio::collision::raycast(map, occ, bench, out); });
+        const double plain = raysPerMs(bench.size(), [&]() { folio::collision::raycast(map, no_skip, bench, out); });
+        const double batch = raysPerMs(bench.size(), [&]() { folio::collision::raycast(map, occ, bench, out, jobs); });
+        std::printf("raycast %-5s: %d rays checked (%d hit, %d corner ties), rays/ms: skip %.0f, no skip %.0f, "
+                    "batch on %zu workers %.0f\n",
+                    c.name, kCheckRays, hit_count, ties, skip, plain, workers, batch);
+    }
+    if (failures > 0)
+    {
+        std::fprintf(stderr, "raycast: %d ray(s) disagree with the plain DDA\n", failures);
+        return 1;
+    }
+    return 0;
+}
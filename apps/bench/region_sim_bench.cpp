@@ -0,0 +1,169 @@
+// Worker-count determinism check for sim::RegionSim (headless, no window)
+//   folio_bench_region_sim [TICKS]    exits non-zero when the result depends on the worker count
+// 20k wandering actors in 16x16 regions step in checkerboard phases; moving between regions and
+// hitting a neighbour come back as effects. The same run with 0, 1, 3 and 7 workers must end in
+// the same state hash. Build with -fsanitize=thread to check the phases for data races as well.
+#include "src/concurrency/job_system.hpp"
+#include "src/sim/region_sim.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <span>
+#include <vector>
+
+namespace
+{
+using folio::geometry::Vec2;
+
+constexpr int kActors = 20000;
+constexpr float kWorld = 4096.f;
+constexpr float kRegion = 256.f;
+constexpr float kSpeed = 80.f;
+constexpr float kReach = 6.f;
+constexpr float kDt = 1.f / 120.f;
+
+struct Actor
+{
+    Vec2 pos{};
+    Vec2 vel{};
+    std::uint32_t rng{1};
+    std::uint32_t hits{0}; // taken from others; only written in merge
+    int region{0};
+};
+
+struct Effect
+{
+    enum class Kind : std::uint8_t
+    {
+        Migrate,
+        Hit
+    };
+    Kind kind{Kind::Migrate};
+    std::uint32_t id{0};
+    int region{0};
+};
+
+std::uint32_t xorshift(std::uint32_t &s)
+{
+    s ^= s << 13;
+    s ^= s >> 17;
+    s ^= s << 5;
+    return s;
+}
+
+struct Result
+{
+    std::uint32_t hash{2166136261u};
+    double ms_per_tick{0.0};
+};
+
+Result run(size_t workers, int ticks)
+{
+    folio::concurrency::JobSystem jobs(workers);
+    folio::sim::RegionSim<Effect> sim(folio::sim::RegionLayout::cover(kWorld, kWorld, kRegion));
+    std::vector<Actor> actors(kActors);
+    std::uint32_t seed = 7;
+    for (Actor &a : actors)
+    {
+        a.pos = {float(xorshift(seed) % 4096u), float(xorshift(seed) % 4096u)};
+        a.rng = xorshift(seed) | 1u;
+        a.region = sim.layout().at(a.pos);
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    for (int t = 0; t < ticks; ++t)
+    {
+        sim.clear();
+        for (std::uint32_t i = 0; i < actors.size(); ++i)
+        {
+            sim.push(actors[i].region, i);
+        }
+        sim.run(jobs, [&](int region, std::span<const std::uint32_t> items, std::vector<Effect> &outbox) {
+            for (const std::uint32_t i : items)
+            {
+                Actor &a = actors[i];
+                if (xorshift(a.rng) % 64 == 0)
+                {
+                    const float ang = float(xorshift(a.rng) % 628) * 0.01f;
+                    a.vel = {std::cos(ang) * kSpeed, std::sin(ang) * kSpeed};
+                }
+                a.pos += a.vel * kDt;
+                if (a.pos.x < 0.f || a.pos.x >= kWorld || a.pos.y < 0.f || a.pos.y >= kWorld)
+                {
+                    a.pos = a.pos - a.vel * kDt;
+                    a.vel = a.vel * -1.f;
+                }
+                // the first region-mate within reach takes a hit (applied after all phases)
+                for (const std::uint32_t j : items)
+                {
+                    const Vec2 d = actors[j].pos - a.pos;
+                    if (j != i && d.x * d.x + d.y * d.y < kReach * kReach)
+                    {
+                        outbox.push_back(Effect{Effect::Kind::Hit, j, region});
+                        break;
+                    }
+                }
+                const int now = sim.layout().at(a.pos);
+                if (now != region)
+                {
+                    outbox.push_back(Effect{Effect::Kind::Migrate, i, now});
+                }
+            }
+        });
+        sim.merge([&](const Effect &e) {
+            if (e.kind == Effect::Kind::Migrate)
+            {
+                actors[e.id].region = e.region;
+            }
+            else
+            {
+                ++actors[e.id].hits;
+            }
+        });
+    }
+    Result r;
+    r.ms_per_tick = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / ticks;
+
+    const auto add = [&r](const void *data, size_t size) {
+        const auto *p = static_cast<const std::uint8_t *>(data);
+        for (size_t k = 0; k < size; ++k)
+        {
+            r.hash = (r.hash ^ p[k]) * 16777619u;
+        }
+    };
+    for (const Actor &a : actors)
+    {
+        add(&a.pos, sizeof(a.pos));
+        add(&a.hits, sizeof(a.hits));
+        add(&a.region, sizeof(a.region));
+    }
+    return r;
+}
+} // namespace
+
+int main(int argc, char **argv)
+{
+    const int ticks = argc > 1 ? std::max(1, std::atoi(argv[1])) : 600;
+    std::uint32_t expected = 0;
+    bool same = true;
+    for (const size_t workers : {size_t(0), size_t(1), size_t(3), size_t(7)})
+    {
+        const Result r = run(workers, ticks);
+        std::printf("region sim: %d actors, %d ticks, %zu workers: %.3f ms/tick, hash %08x\n",
+                    kActors, ticks, workers, r.ms_per_tick, r.hash);
+        if (workers == 0)
+        {
+            expected = r.hash;
+        }
+        same = same && r.hash == expected;
+    }
+    if (!same)
+    {
+        std::fprintf(stderr, "region sim: result depends on the worker count\n");
+        return 1;
+    }
+    return 0;
+}
@@ -1,26 +1,105 @@
 #include "demo_game.hpp"
 #include "src/core/utilities.hpp"
+#include "src/metrics/metrics.hpp"
 #include <SFML/Graphics.hpp>
 #include <random>
 #include <algorithm>
 #include <cmath>
+#include <cstdio>
 
 namespace folio::demo
 {
+namespace
+{
+std::uint32_t xorshift(std::uint32_t &s)
+{
+    s ^= s << 13;
+    s ^= s >> 17;
+    s ^= s << 5;
+    return s;
+}
+
+constexpr int kNpcCount = 2000;
+constexpr float kNpcSpeed = 60.f;
+constexpr float kNpcRadius = 6.f;
+constexpr int kBruteCount = 200;          // the first npcs also swing at the player
+constexpr float kBruteAggro = 40.f;       // gap to the player at which a brute starts its windup
+constexpr std::int64_t kBrutePollTicks = 8; // how often an idle brute looks for the player
+
+constexpr std::uint8_t kOverworldAmbient = 150;
+constexpr std::uint8_t kDungeonAmbient = 40;
+constexpr std::uint8_t kPlayerLight = 255;
+constexpr std::uint8_t kTorchLight = 200;
+constexpr int kTorchCount = 12;
+} // namespace
 
 using geometry::AABB;
 using geometry::Transform;
 
 void DemoGame::init(app::AppContext &ctx)
 {
-    // world
+    // world: both maps stay resident, the dungeon is warmed up on demand
     const int TS = 32;
-    map_ = makeOverworld("overworld", 180, 120, TS);
-    world_bounds_ = world::boundsAABB(map_);
-    iso_ = world::IsoDims{float(TS * 2), float(TS)}; // typical diamond w:h = 2:1
-    iso_bounds_ = world::isoMapBounds(map_, iso_);
-    chunks_ = std::make_unique<world::ChunkCache>(map_, 32);
-    chunks_->setIsometric(iso_);
+    proj_ = geometry::IsoProjection(TS); // typical diamond w:h = 2:1
+    autosave_path_ = save::userDataPath("autosave.bin");
+    seed_ = opts_.replay ? opts_.replay->seed() : opts_.seed;
+    if (!opts_.replay && seed_ == 0)
+    {
+        // no seed given: continue with the last session's seed so that F9 can restore its autosave
+        // (snapshots are deltas against maps generated from the seed)
+        std::vector<std::uint8_t> bytes;
+        if (!save::readFile(autosave_path_, bytes) || !save::readSnapshotSeed(bytes, seed_) || seed_ == 0)
+        {
+            seed_ = std::random_device{}();
+        }
+    }
+    // --map: the overworld comes from an ASCII file and is hot reloaded while playing.
+    // recordings always use the generated map so that they replay from the seed alone
+    world::TileMap overworld;
+    const bool use_file = !opts_.map_path.empty() && !opts_.replay && opts_.record_path.empty();
+    if (use_file && world::readASCIIMap(opts_.map_path, "overworld", TS, overworld))
+    {
+        world::buildColliders(overworld);
+        reloader_ = std::make_unique<world::MapReloader>(opts_.map_path, TS);
+    }
+    else
+    {
+        if (!opts_.map_path.empty())
+        {
+            std::fprintf(stderr, "map: %s not used, falling back to the generated overworld\n", opts_.map_path.c_str());
+        }
+        overworld = makeOverworld("overworld", 180, 120, TS, seed_);
+    }
+    overworld_ = world_.add(std::move(overworld), proj_, 32, kOverworldAmbient);
+    dungeon_ = world_.add(makeDungeon("dungeon", 96, 64, TS, seed_ + 1, dungeon_spawn_), proj_, 32, kDungeonAmbient);
+    onMapEntered();
+    placeLights(seed_ + 3);
+
+    // snapshots store tiles as a delta against the freshly generated maps (indexed by MapId)
+    deltas_.clear();
+    deltas_.emplace_back(world_.map(overworld_), 32);
+    deltas_.emplace_back(world_.map(dungeon_), 32);
+
+    // npcs
+    spawnNpcs(kNpcCount, seed_ + 2);
+    spawnBrutes(kBruteCount);
+
+    // particles
+    particles_.clear();
+    fx::ParticleStyle trail{};
+    trail.color0 = sf::Color(120, 210, 255, 200);
+    trail.color1 = sf::Color(60, 90, 200, 0);
+    trail.size0 = 5.f;
+    trail.size1 = 1.f;
+    trail.drag = 4.f;
+    trail_style_ = particles_.addStyle(trail);
+    fx::ParticleStyle spark{};
+    spark.color0 = sf::Color(255, 230, 150, 255);
+    spark.color1 = sf::Color(255, 120, 40, 0);
+    spark.size0 = 3.f;
+    spark.size1 = 1.f;
+    spark.drag = 4.f;
+    spark_style_ = particles_.addStyle(spark);
 
     // player
     tr_.pos = {TS * 10.f, TS * 10.f};
@@ -28,97 +107,878 @@ void DemoGame::init(app::AppContext &ctx)
 
     // camera
     cam_ = sf::View(sf::FloatRect(sf::Vector2f{0.f, 0.f}, sf::Vector2f{960.f, 540.f}));
+    zoom_ = 1.f;
+
+    // warm up only the chunks on screen; the margin is left to the loop's frame budget
+    jobs_ = ctx.jobs;
+    chunks().appendVisibleRange(cam_, *jobs_);
+    jobs_->drain(0.0, concurrency::Priority::Visible);
 
-    // warm up chunks for initial view
-    chunks_->appendVisibleRange(cam_, jobs_);
-    jobs_.drain();
+    // fixed step graph: movement -> collision resolve, chunk preparation runs alongside
+    tick_graph_.clear();
+    const auto move = tick_graph_.add([this]() { stepMovement(); });
+    const auto collide = tick_graph_.then(move, [this]() { resolveCollisions(); });
+    tick_graph_.then(collide, [this]() { stepNpcs(); });
+    tick_graph_.then(collide, [this]() { stepFx(); });
+    tick_graph_.add([this]() { prepareChunks(); });
+
+    if (!opts_.record_path.empty())
+    {
+        recorder_ = std::make_unique<replay::Recorder>(opts_.record_path, seed_, opts_.hash_state);
+    }
 }
 
 void DemoGame::event(app::AppContext &ctx, const sf::Event &event)
 {
     (void)ctx;
-    (void)event;
+    if (const auto *key = event.getIf<sf::Event::KeyPressed>())
+    {
+        // E: enter / leave the dungeon
+        if (key->code == sf::Keyboard::Key::E)
+        {
+            travel_requested_ = true;
+        }
+        // F5: quick save, F9: quick load (falls back to the last autosave)
+        else if (key->code == sf::Keyboard::Key::F5)
+        {
+            quicksave_ = takeSnapshot();
+        }
+        else if (key->code == sf::Keyboard::Key::F9)
+        {
+            // applied by the next tick's input, so recordings replay the load on the same tick
+            pending_restore_ = quicksave_;
+            if (pending_restore_.empty())
+            {
+                save::readFile(autosave_path_, pending_restore_);
+            }
+        }
+    }
+    // mouse wheel: zoom the camera out / back in (chunk LOD follows in frameUpdate)
+    else if (const auto *wheel = event.getIf<sf::Event::MouseWheelScrolled>())
+    {
+        const float z = clampf(zoom_ * (wheel->delta > 0.f ? 0.8f : 1.25f), kMinZoom, kMaxZoom);
+        cam_.zoom(z / zoom_);
+        zoom_ = z;
+    }
 }
 
 void DemoGame::fixedUpdate(app::AppContext &ctx, float dt)
 {
-    // input
-    in_ = input_.sample();
+    // one tick of input, either from the live devices or from a recording
+    replay::TickInput tick{};
+    std::uint32_t expected_hash = 0;
+    if (opts_.replay)
+    {
+        if (!opts_.replay->next(tick, expected_hash))
+        {
+            return;
+        }
+    }
+    else
+    {
+        tick = sampleInput(ctx, dt);
+        // the map swap happens whenever the background prewarm finishes, so it is recorded as input
+        tick.travel_commit = world_.transitionReady();
+    }
+    applyInput(tick);
+
+    // movement -> collision resolve, chunk preparation overlaps with both
+    // (bakes are drained by GameLoop against the remaining frame budget)
+    step_dt_ = tick.dt;
+    tick_graph_.run(*jobs_);
+    // brute scripts only wake when their wait is up, so idle brutes cost nothing here
+    brains_.tick(step_dt_);
+
+    if (opts_.hash_state && (recorder_ || opts_.replay))
+    {
+        const std::uint32_t hash = hashState();
+        if (recorder_)
+        {
+            recorder_->record(tick, hash);
+        }
+        else if (opts_.replay->hasHash() && hash != expected_hash && diverged_at_ < 0)
+        {
+            diverged_at_ = long(opts_.replay->cursor()) - 1;
+            std::fprintf(stderr, "replay: state diverged at tick %ld\n", diverged_at_);
+        }
+    }
+    else if (recorder_)
+    {
+        recorder_->record(tick);
+    }
+
+    // autosave: encode now, write the file as housekeeping work.
+    // not while recording or replaying: a replay must not replace the player's autosave (and its seed),
+    // and neither run should time snapshot encoding as part of its ticks
+    const bool autosave = !recorder_ && !opts_.replay;
+    autosave_timer_ += dt;
+    if (autosave && autosave_timer_ >= kAutosaveInterval)
+    {
+        autosave_timer_ = 0.f;
+        jobs_->submit([path = autosave_path_, bytes = takeSnapshot()]() { save::writeFile(path, bytes); },
+                      concurrency::Priority::Housekeeping);
+    }
+}
+
+std::uint32_t DemoGame::hashState() const
+{
+    replay::StateHash h;
+    h.add(tr_.pos.x);
+    h.add(tr_.pos.y);
+    h.add(ctrl_.runtime().dash_remain);
+    h.add(ctrl_.runtime().stamina);
+    h.add(facing_right_);
+    h.add(world_.current());
+    h.add(map().tiles.data(), map().tiles.size() * sizeof(int));
+    for (const auto &n : npcs_)
+    {
+        h.add(n.pos.x);
+        h.add(n.pos.y);
+        h.add(n.planted);
+    }
+    h.add(npc_bumps_);
+    h.add(brute_hits_);
+    return h.value();
+}
+
+std::vector<std::uint8_t> DemoGame::takeSnapshot()
+{
+    save::SimState state{};
+    state.seed = seed_;
+    state.current_map = map().id;
+    state.player = tr_;
+    state.move = ctrl_.runtime();
+    state.facing_right = facing_right_;
+    state.actors = encodeActors();
+    auto refs = mapRefs();
+    return save::writeSnapshot(state, refs);
+}
+
+bool DemoGame::restoreSnapshot(const std::vector<std::uint8_t> &bytes)
+{
+    // the snapshot is read into copies of the tiles, then only the differences go through the world
+    // so occupancy, lighting, chunk meshes and colliders are updated for the changed chunks
+    std::vector<world::TileMap> next(deltas_.size());
+    std::vector<save::MapRef> refs;
+    for (world::MapId id = 0; id < deltas_.size(); ++id)
+    {
+        const world::TileMap &live = world_.map(id);
+        next[id].id = live.id;
+        next[id].tile_size = live.tile_size;
+        next[id].w = live.w;
+        next[id].h = live.h;
+        next[id].tiles = live.tiles;
+        refs.push_back(save::MapRef{&next[id], &deltas_[id]});
+    }
+    save::SimState state{};
+    state.seed = seed_;
+    ActorSnapshot actors{};
+    const auto check = [&](const std::vector<std::uint8_t> &raw) { return decodeActors(raw, actors); };
+    if (bytes.empty() || !save::readSnapshot(bytes, state, refs, check))
+    {
+        return false;
+    }
+
+    // a collider build started by a transition may still be reading the tiles
+    world_.waitBuilds(*jobs_);
+    for (world::MapId id = 0; id < refs.size(); ++id)
+    {
+        world_.applyTileChanges(id, world::diffTiles(world_.map(id), next[id]));
+    }
+    world_.setCurrent(world_.find(state.current_map));
+    tr_ = state.player;
+    ctrl_.setRuntime(state.move);
+    facing_right_ = state.facing_right;
+    applyActors(actors);
+    onMapEntered();
+    return true;
+}
+
+std::vector<std::uint8_t> DemoGame::encodeActors() const
+{
+    // everything the npc step reads, including the lod scheduler's bucket order (it is the step order);
+    // npc_region_ is not stored: after every merge it equals the region under each npc's position
+    save::ByteWriter out;
+    out.varint(npcs_.size());
+    for (const Npc &n : npcs_)
+    {
+        out.put(n.pos.x);
+        out.put(n.pos.y);
+        out.put(n.dir.x);
+        out.put(n.dir.y);
+        out.put(n.vel.x);
+        out.put(n.vel.y);
+        out.put(n.turn_in);
+        out.put(n.rng);
+        out.put(std::uint8_t(n.planted ? 1 : 0));
+    }
+    out.put(npc_bumps_);
+
+    const sim::SimLodScheduler::State lod = npc_lod_.state();
+    out.put(lod.time);
+    out.varint(lod.tick);
+    out.varint(lod.scan_cursor);
+    out.varint(lod.last_time.size());
+    for (const double t : lod.last_time)
+    {
+        out.put(t);
+    }
+    out.varint(lod.buckets.size());
+    for (const auto &bucket : lod.buckets)
+    {
+        out.varint(bucket.size());
+        for (const sim::ActorId id : bucket)
+        {
+            out.varint(id);
+        }
+    }
+    out.varint(lod.free.size());
+    for (const sim::ActorId id : lod.free)
+    {
+        out.varint(id);
+    }
+
+    // brutes: their scripts restart from the phase and the ticks left on its wait
+    out.put(brute_hits_);
+    out.varint(brutes_.size());
+    for (const Brute &b : brutes_)
+    {
+        out.put(b.phase);
+        out.varint(bruteWait(b));
+    }
+    return std::move(out.bytes());
+}
+
+bool DemoGame::decodeActors(const std::vector<std::uint8_t> &bytes, ActorSnapshot &out) const
+{
+    save::ByteReader in(bytes.data(), bytes.size());
+    std::uint64_t count = 0;
+    // same seed, same spawn: a different npc count means the snapshot came from another build
+    if (!in.varint(count) || count != npcs_.size())
+    {
+        return false;
+    }
+    out.npcs.resize(size_t(count));
+    for (Npc &n : out.npcs)
+    {
+        std::uint8_t planted = 0;
+        in.get(n.pos.x);
+        in.get(n.pos.y);
+        in.get(n.dir.x);
+        in.get(n.dir.y);
+        in.get(n.vel.x);
+        in.get(n.vel.y);
+        in.get(n.turn_in);
+        in.get(n.rng);
+        in.get(planted);
+        n.planted = planted != 0;
+    }
+    in.get(out.npc_bumps);
+
+    sim::SimLodScheduler::State lod{};
+    std::uint64_t n = 0;
+    in.get(lod.time);
+    in.varint(lod.tick);
+    in.varint(lod.scan_cursor);
+    const auto readIds = [&in](std::vector<sim::ActorId> &ids) {
+        std::uint64_t size = 0;
+        if (!in.varint(size) || size > in.remaining())
+        {
+            return false;
+        }
+        ids.resize(size_t(size));
+        for (sim::ActorId &id : ids)
+        {
+            std::uint64_t v = 0;
+            in.varint(v);
+            id = sim::ActorId(v);
+        }
+        return in.ok();
+    };
+    if (!in.varint(n) || n > in.remaining())
+    {
+        return false;
+    }
+    lod.last_time.resize(size_t(n));
+    for (double &t : lod.last_time)
+    {
+        in.get(t);
+    }
+    if (!in.varint(n) || n > in.remaining())
+    {
+        return false;
+    }
+    lod.buckets.resize(size_t(n));
+    for (auto &bucket : lod.buckets)
+    {
+        if (!readIds(bucket))
+        {
+            return false;
+        }
+    }
+    if (!readIds(lod.free))
+    {
+        return false;
+    }
+
+    in.get(out.brute_hits);
+    if (!in.varint(n) || n != brutes_.size())
+    {
+        return false;
+    }
+    out.brutes.resize(size_t(n));
+    for (auto &[phase, wait] : out.brutes)
+    {
+        in.get(phase);
+        in.varint(wait);
+        if (phase > BrutePhase::Recover)
+        {
+            return false;
+        }
+    }
+    return in.ok() && in.done() && out.npc_lod.setState(lod);
+}
+
+void DemoGame::applyActors(ActorSnapshot &actors)
+{
+    npcs_ = std::move(actors.npcs);
+    npc_bumps_ = actors.npc_bumps;
+    npc_lod_ = std::move(actors.npc_lod);
+    for (sim::ActorId id = 0; id < npcs_.size(); ++id)
+    {
+        npc_region_[id] = npc_regions_.layout().at(npcs_[id].pos);
+    }
+    brute_hits_ = actors.brute_hits;
+    std::vector<std::uint64_t> waits;
+    for (size_t b = 0; b < brutes_.size(); ++b)
+    {
+        brutes_[b].phase = actors.brutes[b].first;
+        waits.push_back(actors.brutes[b].second);
+    }
+    startBrains(waits);
+}
+
+std::vector<save::MapRef> DemoGame::mapRefs()
+{
+    std::vector<save::MapRef> refs;
+    for (world::MapId id = 0; id < deltas_.size(); ++id)
+    {
+        refs.push_back(save::MapRef{&world_.map(id), &deltas_[id]});
+    }
+    return refs;
+}
+
+void DemoGame::paintTile(int tx, int ty, int v)
+{
+    if (world_.setTile(world_.current(), tx, ty, v))
+    {
+        deltas_[world_.current()].markTile(tx, ty);
+    }
+}
+
+void DemoGame::reloadMap(float dt)
+{
+    // a transition may be building colliders in the background; file events stay queued until it's done
+    if (!reloader_ || world_.transitioning())
+    {
+        return;
+    }
+    if (!reloader_->poll(world_.map(overworld_), dt, reload_changes_))
+    {
+        return;
+    }
+    // only the chunks holding changed tiles are rebaked and get their colliders rebuilt
+    world_.applyTileChanges(overworld_, reload_changes_);
+    for (const auto &c : reload_changes_)
+    {
+        deltas_[overworld_].markTile(c.x, c.y);
+    }
+    std::fprintf(stderr, "map reload: %zu tiles changed\n", reload_changes_.size());
+}
+
+void DemoGame::applyInput(const replay::TickInput &tick)
+{
+    if (!tick.restore.empty())
+    {
+        restoreSnapshot(tick.restore);
+    }
+    in_ = tick.in;
+    facing_right_ = tick.facing_right;
+    if (tick.paint_value >= 0)
+    {
+        paintTile(tick.paint_x, tick.paint_y, tick.paint_value);
+    }
+
+    if (tick.travel && !world_.transitioning())
+    {
+        const bool to_dungeon = world_.current() == overworld_;
+        if (to_dungeon)
+        {
+            overworld_return_ = tr_.pos;
+        }
+        const world::MapId to = to_dungeon ? dungeon_ : overworld_;
+        const geometry::Vec2 spawn = to_dungeon ? dungeon_spawn_ : overworld_return_;
+        // light the destination around the spawn first so the prewarmed chunks survive the swap
+        const auto [lx, ly] = world::worldToTile(world_.map(to), spawn.x, spawn.y);
+        world_.lighting(to).moveLight(player_lights_[to], lx, ly);
+        world_.beginTransition(to, spawn, cam_.getSize(), *jobs_);
+    }
+
+    // live: the destination's on-screen chunks and colliders are already ready, so this doesn't stall.
+    // replay: finish the prewarm now so the swap lands on the recorded tick
+    if (tick.travel_commit && world_.transitioning())
+    {
+        tr_.pos = world_.transitionSpawn();
+        world_.completeTransition(*jobs_);
+        onMapEntered();
+    }
+}
+
+void DemoGame::onMapEntered()
+{
+    world_bounds_ = world::boundsAABB(map());
+    iso_bounds_ = geometry::screenBounds(proj_, float(map().w * map().tile_size), float(map().h * map().tile_size));
+    particles_.clear();
+    if (world_.current() == overworld_)
+    {
+        overworld_entered_.signal();
+    }
+}
+
+replay::TickInput DemoGame::sampleInput(app::AppContext &ctx, float dt)
+{
+    replay::TickInput tick{};
+    tick.dt = dt;
+    tick.in = input_.sample();
+    tick.facing_right = facing_right_;
+    tick.travel = travel_requested_;
+    travel_requested_ = false;
+    // like map reloads, a quick load waits until no transition is building colliders in the background
+    if (!world_.transitioning() && !world_.building())
+    {
+        tick.restore = std::move(pending_restore_);
+        pending_restore_.clear();
+    }
     if (ctx.window)
     {
-        facing_right_ = input_.facingRight(*ctx.window, tr_.pos.x);
+        tick.facing_right = input_.facingRight(*ctx.window, tr_.pos.x);
 
         // tile painting: LMB = place wall, RMB = erase
         auto pix = sf::Mouse::getPosition(*ctx.window);
         sf::Vector2i pi{pix.x, pix.y};
         const auto isoP = ctx.window->mapPixelToCoords(pi, cam_);
-        const auto worldP = world::isoToWorld(isoP.x, isoP.y, map_.tile_size, iso_);
-        const int tx = std::clamp(int(std::floor(worldP.x / float(map_.tile_size))), 0, map_.w - 1);
-        const int ty = std::clamp(int(std::floor(worldP.y / float(map_.tile_size))), 0, map_.h - 1);
+        const auto worldP = proj_.toWorld({isoP.x, isoP.y});
+        const int tx = std::clamp(int(std::floor(worldP.x / float(map().tile_size))), 0, map().w - 1);
+        const int ty = std::clamp(int(std::floor(worldP.y / float(map().tile_size))), 0, map().h - 1);
 
+        int paint = -1;
         if (sf::Mouse::isButtonPressed(sf::Mouse::Button::Left))
         {
-            if (map_.tiles[ty * map_.w + tx] != 1)
-            {
-                map_.tiles[ty * map_.w + tx] = 1;
-                chunks_->invalidateTile(tx, ty);
-            }
+            paint = 1;
         }
         else if (sf::Mouse::isButtonPressed(sf::Mouse::Button::Right))
         {
-            if (map_.tiles[ty * map_.w + tx] != 0)
-            {
-                map_.tiles[ty * map_.w + tx] = 0;
-                chunks_->invalidateTile(tx, ty);
-            }
+            paint = 0;
+        }
+        // only actual changes become paint actions, so held buttons don't bloat recordings
+        if (paint >= 0 && map().tiles[ty * map().w + tx] != paint)
+        {
+            tick.paint_value = paint;
+            tick.paint_x = tx;
+            tick.paint_y = ty;
         }
     }
+    return tick;
+}
 
-    // map screen input to world-space direction for isometric equalized speed
-    geometry::Vec2 screen_dir{(in_.right ? 1.f : 0.f) - (in_.left ? 1.f : 0.f),
-                              (in_.down ? 1.f : 0.f) - (in_.up ? 1.f : 0.f)};
-    screen_dir = geometry::norm(screen_dir);
-    geometry::Vec2 world_dir{0.f, 0.f};
-    if (geometry::len(screen_dir) > 0.f)
-    {
-        const float sx = iso_.w * 0.5f;
-        const float sy = iso_.h * 0.5f;
-        // inverse of iso projection matrix to get world direction from screen vector
-        float fx = 0.5f * (screen_dir.x / sx + screen_dir.y / sy);
-        float fy = 0.5f * (-screen_dir.x / sx + screen_dir.y / sy);
-        world_dir = geometry::norm({fx, fy});
-    }
-
-    // move attempt using isometric-aware direction
-    const geometry::Vec2 prev = tr_.pos;
-    ctrl_.tickIso(tr_, in_, world_dir, folio::FixedDelta{dt}, world_bounds_);
+void DemoGame::stepMovement()
+{
+    // screen input is mapped through the projection, so iso movement keeps an equal on-screen speed
+    prev_pos_ = tr_.pos;
+    ctrl_.tick(tr_, in_, proj_, folio::FixedDelta{step_dt_}, world_bounds_);
+}
 
-    // collision resolve: AABB approx + axis rollback
+void DemoGame::resolveCollisions()
+{
     // collision resolve: axis-wise separate (X then Y) to avoid full stop on touch
-    geometry::AABB me{tr_.pos.x - tr_.r, tr_.pos.y - tr_.r, tr_.r * 2, tr_.r * 2};
+    const geometry::Vec2 prev = prev_pos_;
+    bumped_ = false;
     // resolve X
     geometry::AABB meX{tr_.pos.x - tr_.r, prev.y - tr_.r, tr_.r * 2, tr_.r * 2};
     if (anyHit(meX))
     {
         tr_.pos.x = prev.x;
+        bumped_ = true;
     }
     // resolve Y with possibly corrected X
     geometry::AABB meY{tr_.pos.x - tr_.r, tr_.pos.y - tr_.r, tr_.r * 2, tr_.r * 2};
     if (anyHit(meY))
     {
         tr_.pos.y = prev.y;
+        bumped_ = true;
+    }
+}
+
+void DemoGame::prepareChunks()
+{
+    chunks().appendVisibleRange(cam_, *jobs_);
+}
+
+void DemoGame::stepFx()
+{
+    // the trail follows the dash; sparks fly back off the wall the player ran into
+    if (ctrl_.runtime().dash_remain > 0.f)
+    {
+        fx::Emitter e{};
+        e.pos = tr_.pos;
+        e.radius = tr_.r * 0.5f;
+        e.speed_min = 5.f;
+        e.speed_max = 25.f;
+        e.life_min = 0.2f;
+        e.life_max = 0.45f;
+        e.style = trail_style_;
+        particles_.emit(e, 12);
+    }
+    if (bumped_ && ctrl_.runtime().dash_remain > 0.f)
+    {
+        fx::Emitter e{};
+        e.pos = tr_.pos;
+        e.dir = geometry::norm(prev_pos_ - tr_.pos);
+        e.spread = 1.2f;
+        e.speed_min = 80.f;
+        e.speed_max = 220.f;
+        e.life_min = 0.15f;
+        e.life_max = 0.35f;
+        e.style = spark_style_;
+        particles_.emit(e, 24);
+    }
+    particles_.update(step_dt_);
+}
+
+void DemoGame::stepNpcs()
+{
+    // npcs live on the overworld; while the player is elsewhere their clock keeps running and is caught up on return
+    if (world_.current() != overworld_)
+    {
+        npc_lod_.advance(step_dt_);
+        return;
+    }
+    // due steps are bucketed by owning region and run in checkerboard phases on the workers;
+    // region changes and player contacts come back through the outboxes in a fixed order,
+    // so the result (and the replay hash) doesn't depend on the worker count
+    npc_steps_.clear();
+    npc_lod_.collect(step_dt_, tr_.pos, [this](sim::ActorId id) { return npcs_[id].pos; }, npc_steps_);
+    avoidNpcs();
+    npc_regions_.clear();
+    for (std::uint32_t i = 0; i < npc_steps_.size(); ++i)
+    {
+        npc_regions_.push(npc_region_[npc_steps_[i].id], i);
+    }
+    npc_regions_.run(*jobs_, [this](int region, std::span<const std::uint32_t> items, std::vector<NpcEffect> &outbox) {
+        stepNpcRegion(region, items, outbox);
+    });
+    npc_regions_.merge([this](const NpcEffect &e) {
+        if (e.kind == NpcEffect::Kind::Migrate)
+        {
+            npc_region_[e.id] = e.region;
+            return;
+        }
+        // bumped into the player: turn around
+        ++npc_bumps_;
+        npcs_[e.id].dir = npcs_[e.id].dir * -1.f;
+        npcs_[e.id].vel = npcs_[e.id].dir * kNpcSpeed;
+        npcs_[e.id].turn_in = 0.5f;
+    });
+}
+
+void DemoGame::avoidNpcs()
+{
+    // npcs near the player steer around each other and the walls; the rest just wander
+    npc_agents_.resize(npcs_.size());
+    for (size_t i = 0; i < npcs_.size(); ++i)
+    {
+        const Npc &n = npcs_[i];
+        const geometry::Vec2 want = n.planted ? geometry::Vec2{} : n.dir * kNpcSpeed;
+        npc_agents_[i] = movement::AvoidanceAgent{n.pos, n.vel, want, kNpcRadius, kNpcSpeed};
+    }
+    npc_avoid_ids_.clear();
+    for (const sim::SimStep &s : npc_steps_)
+    {
+        if (npc_lod_.tier(s.id) != sim::SimTier::Full)
+        {
+            npcs_[s.id].vel = npc_agents_[s.id].pref_vel;
+        }
+        // catch-up steps of one npc are consecutive
+        else if (npc_avoid_ids_.empty() || npc_avoid_ids_.back() != s.id)
+        {
+            npc_avoid_ids_.push_back(s.id);
+        }
+    }
+    npc_avoid_vel_.resize(npc_avoid_ids_.size());
+    const auto &m = world_.map(overworld_);
+    npc_avoid_.solve(npc_agents_, npc_avoid_ids_, npc_avoid_vel_, step_dt_,
+                     [&m](int tx, int ty) { return m.isWall(tx, ty); }, m.tile_size, jobs_);
+    for (size_t k = 0; k < npc_avoid_ids_.size(); ++k)
+    {
+        npcs_[npc_avoid_ids_[k]].vel = npc_avoid_vel_[k];
+    }
+}
+
+void DemoGame::stepNpcRegion(int region, std::span<const std::uint32_t> items, std::vector<NpcEffect> &outbox)
+{
+    const float contact = tr_.r + 6.f;
+    for (size_t k = 0; k < items.size(); ++k)
+    {
+        const sim::SimStep &s = npc_steps_[items[k]];
+        stepNpc(s.id, s.dt);
+        // an npc's catch-up steps are consecutive; report once after the last one
+        if (k + 1 < items.size() && npc_steps_[items[k + 1]].id == s.id)
+        {
+            continue;
+        }
+        const Npc &n = npcs_[s.id];
+        const int now = npc_regions_.layout().at(n.pos);
+        if (now != region)
+        {
+            outbox.push_back(NpcEffect{NpcEffect::Kind::Migrate, s.id, now});
+        }
+        const geometry::Vec2 d = n.pos - tr_.pos;
+        if (d.x * d.x + d.y * d.y < contact * contact)
+        {
+            outbox.push_back(NpcEffect{NpcEffect::Kind::Bump, s.id, now});
+        }
+    }
+}
+
+void DemoGame::spawnNpcs(int count, std::uint32_t seed)
+{
+    const auto &m = world_.map(overworld_);
+    npcs_.clear();
+    npc_lod_ = sim::SimLodScheduler{};
+    npc_region_.clear();
+    npc_bumps_ = 0;
+    // regions of 16x16 tiles: small enough that each checkerboard phase has work for every worker
+    npc_regions_.reset(sim::RegionLayout::cover(float(m.w * m.tile_size), float(m.h * m.tile_size), 16.f * m.tile_size));
+    std::mt19937 rng{seed};
+    std::uniform_int_distribution<int> rx(1, m.w - 2), ry(1, m.h - 2);
+    while (int(npcs_.size()) < count)
+    {
+        const int tx = rx(rng), ty = ry(rng);
+        if (m.isWall(tx, ty))
+        {
+            continue;
+        }
+        Npc n;
+        n.pos = {(tx + 0.5f) * m.tile_size, (ty + 0.5f) * m.tile_size};
+        n.rng = rng() | 1u;
+        npcs_.push_back(n);
+        npc_region_.push_back(npc_regions_.layout().at(n.pos));
+        npc_lod_.add();
+    }
+}
+
+void DemoGame::stepNpc(sim::ActorId id, float dt)
+{
+    Npc &n = npcs_[id];
+    if (n.planted)
+    {
+        return;
+    }
+    n.turn_in -= dt;
+    if (n.turn_in <= 0.f)
+    {
+        const float a = float(xorshift(n.rng) % 628) * 0.01f;
+        n.dir = {std::cos(a), std::sin(a)};
+        n.turn_in = 1.f + float(xorshift(n.rng) % 300) * 0.01f;
+        n.vel = n.dir * kNpcSpeed;
+    }
+    const auto &m = world_.map(overworld_);
+    const geometry::Vec2 next = n.pos + n.vel * dt;
+    const auto [tx, ty] = world::worldToTile(m, next.x, next.y);
+    if (m.isWall(tx, ty))
+    {
+        n.turn_in = 0.f; // blocked: pick a new direction next step
+        return;
+    }
+    n.pos = next;
+}
+
+void DemoGame::spawnBrutes(int count)
+{
+    brutes_.clear();
+    for (sim::ActorId id = 0; id < npcs_.size() && int(brutes_.size()) < count; ++id)
+    {
+        Brute b{};
+        b.npc = id;
+        b.fighter.team = combat::Team::Enemy;
+        b.fighter.windup = 0.35f; // slow enough to dash out of
+        b.fighter.recover = 0.6f;
+        brutes_.push_back(b);
     }
+    startBrains({});
+}
+
+void DemoGame::startBrains(const std::vector<std::uint64_t> &waits)
+{
+    // (re)start every brute's script in its current phase; waits[b] is the tick count left on its wait
+    for (std::uint32_t b = 0; b < brutes_.size(); ++b)
+    {
+        brains_.kill(brutes_[b].brain);
+        brutes_[b].brain = brains_.spawn(bruteBrain(brains_, b, b < waits.size() ? waits[b] : 0));
+    }
+}
+
+std::uint64_t DemoGame::bruteWait(const Brute &b) const
+{
+    const std::uint64_t now = brains_.now();
+    switch (b.phase)
+    {
+    case BrutePhase::Watch:
+        return kBrutePollTicks - (now - b.mark) % kBrutePollTicks; // next reach check
+    case BrutePhase::Windup:
+    case BrutePhase::Recover:
+        return b.mark > now ? b.mark - now : 0;
+    default:
+        return 0;
+    }
+}
+
+behavior::Behavior DemoGame::bruteBrain(behavior::Scheduler &sched, std::uint32_t brute, std::uint64_t wait)
+{
+    // each phase notes its wake tick in the brute, and a restarted script begins with the saved remainder
+    Brute &b = brutes_[brute];
+    Npc &n = npcs_[b.npc];
+    for (;;)
+    {
+        switch (b.phase)
+        {
+        case BrutePhase::Away:
+            if (world_.current() != overworld_)
+            {
+                co_await overworld_entered_;
+            }
+            b.phase = BrutePhase::Watch;
+            break;
+        case BrutePhase::Watch:
+            // a restarted brute first lines up with its saved poll phase
+            co_await behavior::ticks(std::int64_t(std::exchange(wait, 0)));
+            b.mark = sched.now();
+            co_await behavior::until([this, brute]() { return world_.current() != overworld_ || bruteInReach(brute, kBruteAggro); },
+                                     kBrutePollTicks);
+            if (world_.current() != overworld_)
+            {
+                b.phase = BrutePhase::Away;
+                break;
+            }
+            // plant, wind up, swing at wherever the player is now, recover
+            n.planted = true;
+            n.vel = {};
+            b.phase = BrutePhase::Windup;
+            wait = sched.ticksFor(b.fighter.windup);
+            break;
+        case BrutePhase::Windup:
+            b.mark = sched.now() + wait;
+            co_await behavior::ticks(std::int64_t(std::exchange(wait, 0)));
+            if (world_.current() == overworld_)
+            {
+                bruteStrike(brute);
+            }
+            b.phase = BrutePhase::Recover;
+            wait = sched.ticksFor(b.fighter.recover);
+            break;
+        case BrutePhase::Recover:
+            b.mark = sched.now() + wait;
+            co_await behavior::ticks(std::int64_t(std::exchange(wait, 0)));
+            n.planted = false;
+            n.turn_in = 0.f;
+            b.phase = BrutePhase::Watch;
+            break;
+        }
+    }
+}
+
+bool DemoGame::bruteInReach(std::uint32_t brute, float range) const
+{
+    const Npc &n = npcs_[brutes_[brute].npc];
+    return geometry::len(tr_.pos - n.pos) <= range + tr_.r + kNpcRadius;
+}
+
+void DemoGame::bruteStrike(std::uint32_t brute)
+{
+    const Brute &b = brutes_[brute];
+    const Npc &n = npcs_[b.npc];
+    const geometry::AABB slash =
+        combat::makeSlashBox(geometry::Transform{n.pos, kNpcRadius}, tr_.pos.x >= n.pos.x, b.fighter.atk_range);
+    const geometry::AABB me{tr_.pos.x - tr_.r, tr_.pos.y - tr_.r, tr_.r * 2, tr_.r * 2};
+    if (!aabbOverlap(slash, me))
+    {
+        return;
+    }
+    ++brute_hits_;
+    fx::Emitter e{};
+    e.pos = tr_.pos;
+    e.dir = geometry::norm(tr_.pos - n.pos);
+    e.spread = 0.6f;
+    e.speed_min = 60.f;
+    e.speed_max = 160.f;
+    e.life_min = 0.15f;
+    e.life_max = 0.35f;
+    e.style = spark_style_;
+    particles_.emit(e, 24);
+}
+
+void DemoGame::placeLights(std::uint32_t seed)
+{
+    // the player carries a light on every map; it only moves on the current one
+    // (and to the spawn of a map being prewarmed)
+    player_lights_.clear();
+    for (const world::MapId id : {overworld_, dungeon_})
+    {
+        player_lights_.resize(std::max<size_t>(player_lights_.size(), id + 1));
+        player_lights_[id] = world_.lighting(id).addLight(0, 0, kPlayerLight);
+    }
+
+    // torches on random dungeon floor tiles
+    const auto &m = world_.map(dungeon_);
+    std::mt19937 rng{seed};
+    std::uniform_int_distribution<int> rx(0, m.w - 1), ry(0, m.h - 1);
+    for (int placed = 0, tries = 0; placed < kTorchCount && tries < 1000; ++tries)
+    {
+        const int x = rx(rng), y = ry(rng);
+        if (!m.isWall(x, y))
+        {
+            world_.lighting(dungeon_).addLight(x, y, kTorchLight);
+            ++placed;
+        }
+    }
+}
 
-    // prepare chunks
-    chunks_->appendVisibleRange(cam_, jobs_);
-    jobs_.drain(0.001); // small budget per fixed step
+void DemoGame::updateLighting()
+{
+    // lighting is visual only: it follows the rendered player and is never hashed or saved
+    const auto [tx, ty] = world::worldToTile(map(), tr_.pos.x, tr_.pos.y);
+    world_.currentLighting().moveLight(player_lights_[world_.current()], tx, ty);
+    // re-propagated on a worker; the results land in the next background drain
+    world_.updateLighting(world_.current(), *jobs_);
+    // a pending transition lights its destination before baking it
+    world_.updateTransition(*jobs_);
 }
 
 void DemoGame::frameUpdate(app::AppContext &ctx, float ft)
 {
-    (void)ft;
+    reloadMap(ft);
+    updateLighting();
+
+    // zoomed-out views switch to coarser chunk meshes; both maps follow so a transition prefetches at the same level
+    if (ctx.window && ctx.window->getSize().x > 0)
+    {
+        const float world_per_pixel = cam_.getSize().x / float(ctx.window->getSize().x);
+        world_.chunks(overworld_).updateLod(world_per_pixel);
+        world_.chunks(dungeon_).updateLod(world_per_pixel);
+    }
+
     // camera follows player in isometric space and clamps to iso map bounds
-    const auto isoPos = world::worldToIso(tr_.pos.x, tr_.pos.y, map_.tile_size, iso_);
+    const auto isoPos = proj_.toScreen(tr_.pos);
     const float hw = cam_.getSize().x * 0.5f;
     const float hh = cam_.getSize().y * 0.5f;
     const float cx = clampf(isoPos.x, iso_bounds_.x + hw, iso_bounds_.x + iso_bounds_.w - hw);
@@ -133,11 +993,39 @@ void DemoGame::render(app::AppContext &ctx)
     win.clear(sf::Color(28, 30, 34));
 
     // draw chunks
-    chunks_->drawVisible(win, cam_);
+    chunks().drawVisible(win, cam_);
+
+    // npcs (dormant ones are off screen by construction)
+    if (world_.current() == overworld_)
+    {
+        npc_verts_.clear();
+        for (sim::ActorId id = 0; id < npcs_.size(); ++id)
+        {
+            if (npc_lod_.tier(id) == sim::SimTier::Dormant)
+            {
+                continue;
+            }
+            const auto p = proj_.toScreen(npcs_[id].pos);
+            const sf::Color c = npcs_[id].planted ? sf::Color(255, 80, 60)
+                                : id < brutes_.size() ? sf::Color(200, 120, 90)
+                                                      : sf::Color(230, 190, 90);
+            const sf::Vector2f t{p.x, p.y - 6.f}, r{p.x + 5.f, p.y}, b{p.x, p.y + 6.f}, l{p.x - 5.f, p.y};
+            for (const auto &v : {t, r, b, t, b, l})
+            {
+                npc_verts_.push_back(sf::Vertex{v, c});
+            }
+        }
+        win.draw(npc_verts_.data(), npc_verts_.size(), sf::PrimitiveType::Triangles);
+    }
+
+    // particles: one vertex buffer for all of them
+    fx_verts_.clear();
+    particles_.appendVertices(fx_verts_, [&](const geometry::Vec2 &p) { return proj_.toScreen(p); });
+    win.draw(fx_verts_.data(), fx_verts_.size(), sf::PrimitiveType::Triangles);
 
     // player
     // draw player at projected isometric position
-    const auto ip = world::worldToIso(tr_.pos.x, tr_.pos.y, map_.tile_size, iso_);
+    const auto ip = proj_.toScreen(tr_.pos);
     sf::CircleShape pc(tr_.r, 18);
     pc.setOrigin(sf::Vector2f{tr_.r, tr_.r});
     pc.setPosition(sf::Vector2f{ip.x, ip.y});
@@ -156,14 +1044,29 @@ void DemoGame::render(app::AppContext &ctx)
     bar.setPosition(sf::Vector2f{16.f, 16.f});
     bar.setFillColor(sf::Color(90, 200, 120));
     win.draw(bar);
+
+    // background backlog: visible bakes the frame budget couldn't fit
+    const auto &bg = ctx.frame.background;
+    sf::RectangleShape backlog(sf::Vector2f{std::min(240.f, 4.f * float(bg.deferred[0])), 4.f});
+    backlog.setPosition(sf::Vector2f{16.f, 30.f});
+    backlog.setFillColor(sf::Color(220, 120, 80));
+    win.draw(backlog);
 }
 
 void DemoGame::shutdown(app::AppContext &ctx)
 {
     (void)ctx;
+    if (recorder_)
+    {
+        recorder_->close();
+    }
+    if (opts_.replay && opts_.replay->hasHash() && opts_.hash_state && diverged_at_ < 0)
+    {
+        std::fprintf(stderr, "replay: %zu ticks matched\n", opts_.replay->cursor());
+    }
 }
 
-world::TileMap DemoGame::makeOverworld(const std::string &id, int W, int H, int tile_size)
+world::TileMap DemoGame::makeOverworld(const std::string &id, int W, int H, int tile_size, std::uint32_t seed)
 {
     world::TileMap m;
     m.id = id;
@@ -191,7 +1094,7 @@ world::TileMap DemoGame::makeOverworld(const std::string &id, int W, int H, int
         m.tiles[y * W + (W / 2)] = 0;
 
     // random clusters
-    std::mt19937 rng{std::random_device{}()};
+    std::mt19937 rng{seed};
     std::uniform_int_distribution<int> rx(2, W - 3), ry(2, H - 3), rs(2, 7);
     for (int i = 0; i < 120; ++i)
     {
@@ -202,16 +1105,49 @@ world::TileMap DemoGame::makeOverworld(const std::string &id, int W, int H, int
     }
 
     // build colliders
-    for (int y = 0; y < H; ++y)
+    world::buildColliders(m);
+    return m;
+}
+
+world::TileMap DemoGame::makeDungeon(const std::string &id, int W, int H, int tile_size, std::uint32_t seed, geometry::Vec2 &spawn)
+{
+    world::TileMap m;
+    m.id = id;
+    m.w = W;
+    m.h = H;
+    m.tile_size = tile_size;
+    m.tiles.assign(W * H, 1);
+
+    // rooms carved out of solid rock, each linked to the previous one by an L corridor
+    std::mt19937 rng{seed};
+    std::uniform_int_distribution<int> rw(6, 14), rh(5, 10);
+    int px = -1, py = -1;
+    for (int i = 0; i < 14; ++i)
     {
-        for (int x = 0; x < W; ++x)
+        const int w = rw(rng), h = rh(rng);
+        const int x0 = std::uniform_int_distribution<int>(1, W - w - 2)(rng);
+        const int y0 = std::uniform_int_distribution<int>(1, H - h - 2)(rng);
+        for (int y = y0; y < y0 + h; ++y)
+            for (int x = x0; x < x0 + w; ++x)
+                m.tiles[y * W + x] = 0;
+
+        const int cx = x0 + w / 2, cy = y0 + h / 2;
+        if (px < 0)
         {
-            if (m.tiles[y * W + x] == 1)
-            {
-                m.colliders.push_back(geometry::AABB{float(x * tile_size), float(y * tile_size), float(tile_size), float(tile_size)});
-            }
+            spawn = {(cx + 0.5f) * tile_size, (cy + 0.5f) * tile_size};
         }
+        else
+        {
+            for (int x = std::min(px, cx); x <= std::max(px, cx); ++x)
+                m.tiles[py * W + x] = 0;
+            for (int y = std::min(py, cy); y <= std::max(py, cy); ++y)
+                m.tiles[y * W + cx] = 0;
+        }
+        px = cx;
+        py = cy;
     }
+
+    // colliders are built in the background by World::beginTransition
     return m;
 }
 
@@ -222,16 +1158,23 @@ bool DemoGame::aabbOverlap(const geometry::AABB &a, const geometry::AABB &b) con
 
 bool DemoGame::anyHit(const geometry::AABB &box) const
 {
-    const int TS = map_.tile_size;
+    static metrics::Counter &queries = metrics::counter("collision.box_queries");
+    queries.add();
+    const int TS = map().tile_size;
     const int minX = std::max(0, int(std::floor(box.x / TS)));
-    const int maxX = std::min(map_.w - 1, int(std::floor((box.x + box.w) / TS)));
+    const int maxX = std::min(map().w - 1, int(std::floor((box.x + box.w) / TS)));
     const int minY = std::max(0, int(std::floor(box.y / TS)));
-    const int maxY = std::min(map_.h - 1, int(std::floor((box.y + box.h) / TS)));
+    const int maxY = std::min(map().h - 1, int(std::floor((box.y + box.h) / TS)));
+    // most boxes sit in open floor: the occupancy bitmasks answer that without touching tiles
+    if (!world_.currentOccupancy().anyWall(minX, minY, maxX + 1, maxY + 1))
+    {
+        return false;
+    }
     for (int ty = minY; ty <= maxY; ++ty)
     {
         for (int tx = minX; tx <= maxX; ++tx)
         {
-            if (!map_.isWall(tx, ty))
+            if (!map().isWall(tx, ty))
                 continue;
             geometry::AABB aabb{float(tx * TS), float(ty * TS), float(TS), float(TS)};
             if (aabbOverlap(box, aabb))
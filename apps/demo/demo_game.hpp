@@ -2,21 +2,48 @@
 
 #include "apps/interface/game.hpp"
 #include "adapters/sfml/sfml_input.hpp"
+#include "src/behavior/behavior.hpp"
+#include "src/combat/fighter.hpp"
 #include "src/core/input.hpp"
+#include "src/fx/particles.hpp"
 #include "src/concurrency/job_system.hpp"
+#include "src/concurrency/task_graph.hpp"
+#include "src/geometry/projection.hpp"
 #include "src/geometry/types.hpp"
+#include "src/movement/avoidance.hpp"
 #include "src/movement/character_controller.hpp"
+#include "src/replay/replay.hpp"
+#include "src/save/snapshot.hpp"
+#include "src/sim/lod_scheduler.hpp"
+#include "src/sim/region_sim.hpp"
 #include "src/world/chunks.hpp"
 #include "src/world/tile_map.hpp"
-#include "src/world/iso.hpp"
+#include "src/world/map_reload.hpp"
+#include "src/world/world.hpp"
+#include <cstdint>
 #include <memory>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
 
 namespace folio::demo
 {
 
+struct DemoOptions
+{
+    std::uint32_t seed{0};              // 0 = the last autosave's seed, else random
+    std::string record_path{};          // non-empty: record every tick's input here
+    replay::Replayer *replay{nullptr};  // drive the simulation from a recording instead of devices
+    bool hash_state{true};              // per-tick state hash while recording / replaying
+    std::string map_path{};             // non-empty: overworld from this ASCII file, hot reloaded on save
+};
+
 class DemoGame : public app::Game
 {
 public:
+    explicit DemoGame(DemoOptions opts = {}) : opts_(std::move(opts)) {}
+
     void init(app::AppContext &ctx) override;
     void event(app::AppContext &ctx, const sf::Event &event) override;
     void fixedUpdate(app::AppContext &ctx, float dt) override;
@@ -24,25 +51,167 @@ public:
     void render(app::AppContext &ctx) override;
     void shutdown(app::AppContext &ctx) override;
 
+    // replay: the state hash stopped matching the recording
+    bool diverged() const { return diverged_at_ >= 0; }
+
 private:
-    world::TileMap makeOverworld(const std::string &id, int W, int H, int tile_size);
+    world::TileMap makeOverworld(const std::string &id, int W, int H, int tile_size, std::uint32_t seed);
+    world::TileMap makeDungeon(const std::string &id, int W, int H, int tile_size, std::uint32_t seed, geometry::Vec2 &spawn);
     bool aabbOverlap(const geometry::AABB &a, const geometry::AABB &b) const;
     bool anyHit(const geometry::AABB &box) const;
 
+    // current map (hot path goes through the interned id, never the name)
+    world::TileMap &map() { return world_.currentMap(); }
+    const world::TileMap &map() const { return world_.currentMap(); }
+    world::IsoChunkCache &chunks() { return world_.currentChunks(); }
+
+    void onMapEntered();
+    void paintTile(int tx, int ty, int v);
+    void reloadMap(float dt);
+
+    // save / load
+    std::vector<std::uint8_t> takeSnapshot();
+    bool restoreSnapshot(const std::vector<std::uint8_t> &bytes);
+    std::vector<save::MapRef> mapRefs();
+
+    // input: sampled live (or read from a replay), then applied the same way
+    replay::TickInput sampleInput(app::AppContext &ctx, float dt);
+    void applyInput(const replay::TickInput &tick);
+    std::uint32_t hashState() const;
+
+    // fixed step stages (tick_graph_ nodes)
+    void stepMovement();
+    void resolveCollisions();
+    void prepareChunks();
+    void stepNpcs();
+    void stepFx();
+
+    // overworld wanderers, ticked by distance to the player through npc_lod_
+    struct Npc
+    {
+        geometry::Vec2 pos{};
+        geometry::Vec2 dir{};
+        geometry::Vec2 vel{}; // wander velocity after local avoidance
+        float turn_in{0.f}; // seconds until the next direction change
+        std::uint32_t rng{1};
+        bool planted{false}; // a brute mid-swing stands still
+    };
+    // npcs that swing at the player; driven by a behaviour coroutine each
+    enum class BrutePhase : std::uint8_t
+    {
+        Away,    // waiting for the player to come back to the overworld
+        Watch,   // polling for the player in reach
+        Windup,
+        Recover
+    };
+    struct Brute
+    {
+        sim::ActorId npc{0};
+        combat::Fighter fighter{};
+        behavior::BehaviorId brain{};
+        // where the script is, so a snapshot can restart it at the same point
+        BrutePhase phase{BrutePhase::Watch};
+        std::uint64_t mark{0}; // brains_.now() tick: Watch = polling started, Windup/Recover = wait ends
+    };
+    // cross-region results of an npc step, merged in region order after all phases
+    struct NpcEffect
+    {
+        enum class Kind : std::uint8_t
+        {
+            Migrate, // moved into another region
+            Bump     // touched the player
+        };
+        Kind kind{Kind::Migrate};
+        sim::ActorId id{0};
+        int region{0};
+    };
+    // npc and brute state carried in save::SimState::actors; decoded in full before anything is applied
+    struct ActorSnapshot
+    {
+        std::vector<Npc> npcs{};
+        std::uint32_t npc_bumps{0};
+        sim::SimLodScheduler npc_lod{};
+        std::vector<std::pair<BrutePhase, std::uint64_t>> brutes{}; // phase, ticks until the next wake
+        std::uint32_t brute_hits{0};
+    };
+    std::vector<std::uint8_t> encodeActors() const;
+    bool decodeActors(const std::vector<std::uint8_t> &bytes, ActorSnapshot &out) const;
+    void applyActors(ActorSnapshot &actors);
+    void spawnNpcs(int count, std::uint32_t seed);
+    void stepNpc(sim::ActorId id, float dt);
+    void avoidNpcs();
+    void stepNpcRegion(int region, std::span<const std::uint32_t> items, std::vector<NpcEffect> &outbox);
+    void spawnBrutes(int count);
+    void startBrains(const std::vector<std::uint64_t> &waits);
+    std::uint64_t bruteWait(const Brute &b) const;
+    behavior::Behavior bruteBrain(behavior::Scheduler &sched, std::uint32_t brute, std::uint64_t wait);
+    bool bruteInReach(std::uint32_t brute, float range) const;
+    void bruteStrike(std::uint32_t brute);
+
+    // tile lights: the player's light plus dungeon torches
+    void placeLights(std::uint32_t seed);
+    void updateLighting();
+
 private:
+    DemoOptions opts_{};
+    std::unique_ptr<replay::Recorder> recorder_{};
+    long diverged_at_{-1};
+
     adapters::SfmlInput input_{};
     movement::CharacterController ctrl_{};
     core::InputState in_{};
     geometry::Transform tr_{};
     bool facing_right_{true};
 
-    world::TileMap map_{};
-    std::unique_ptr<world::ChunkCache> chunks_{};
+    world::IsoWorld world_{};
+    world::MapId overworld_{world::kInvalidMap};
+    world::MapId dungeon_{world::kInvalidMap};
+    geometry::Vec2 dungeon_spawn_{};
+    geometry::Vec2 overworld_return_{};
+    bool travel_requested_{false};
+
+    static constexpr float kAutosaveInterval = 5.f;
+    std::string autosave_path_{}; // 사용자 데이터 디렉터리 (작업 디렉터리에 쓰지 않음)
+    std::uint32_t seed_{0};
+    std::vector<save::MapDelta> deltas_{};
+    std::vector<std::uint8_t> quicksave_{};
+    std::vector<std::uint8_t> pending_restore_{}; // F9: goes out with the next tick's input
+    float autosave_timer_{0.f};
     geometry::AABB world_bounds_{};
     geometry::AABB iso_bounds_{};
     sf::View cam_{};
-    concurrency::JobSystem jobs_{1};
-    world::IsoDims iso_{};
+    static constexpr float kMinZoom = 0.5f;
+    static constexpr float kMaxZoom = 6.f;
+    float zoom_{1.f};
+    concurrency::JobSystem *jobs_{nullptr}; // owned by app::GameLoop
+    concurrency::TaskGraph tick_graph_{};
+    float step_dt_{0.f};
+    geometry::Vec2 prev_pos_{};
+    std::vector<Npc> npcs_{}; // indexed by sim::ActorId
+    std::unique_ptr<world::MapReloader> reloader_{};
+    std::vector<world::TileChange> reload_changes_{};
+    sim::SimLodScheduler npc_lod_{};
+    sim::RegionSim<NpcEffect> npc_regions_{};
+    std::vector<int> npc_region_{};           // region owning each npc, indexed by sim::ActorId
+    std::vector<sim::SimStep> npc_steps_{};   // this tick's due steps from npc_lod_
+    std::uint32_t npc_bumps_{0};
+    movement::CrowdAvoidance npc_avoid_{};
+    std::vector<movement::AvoidanceAgent> npc_agents_{};
+    std::vector<std::uint32_t> npc_avoid_ids_{};
+    std::vector<geometry::Vec2> npc_avoid_vel_{};
+    std::vector<sf::Vertex> npc_verts_{};
+    std::vector<Brute> brutes_{};
+    behavior::Scheduler brains_{};       // resumed once per fixed step, after the tick graph
+    behavior::Event overworld_entered_{}; // brutes idle on it while the player is away
+    std::uint32_t brute_hits_{0};
+    std::vector<world::LightId> player_lights_{}; // indexed by MapId
+    // dash trail and wall-bump sparks; visual only, never hashed
+    fx::ParticlePool particles_{20000};
+    std::uint8_t trail_style_{0};
+    std::uint8_t spark_style_{0};
+    bool bumped_{false}; // resolveCollisions rolled the player back this tick
+    std::vector<sf::Vertex> fx_verts_{};
+    geometry::IsoProjection proj_{}; // world <-> screen for rendering, picking and movement
 };
 
 } // namespace folio::demo
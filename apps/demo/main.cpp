@@ -1,17 +1,92 @@
 // Demo entry bootstraps the GameLoop with DemoGame
+//   folio_demo [--seed N] [--record FILE]   play (optionally recording every tick's input)
+//   folio_demo --map FILE                   play on an ASCII overworld, reloaded whenever FILE is saved
+//   folio_demo --replay FILE [--workers N]  re-run a recording headless and check state hashes
+//                                           (exit 1 on divergence; compare worker counts for determinism)
+//   --metrics FILE|-                        dump runtime metrics every 5 s (JSON Lines, or text to stderr)
 #include "apps/app_core/game_loop.hpp"
 #include "demo_game.hpp"
+#include "src/metrics/metrics.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <string>
 
-int main()
+namespace
 {
+void usage(const char *exe)
+{
+    std::fprintf(stderr,
+                 "usage: %s [--seed N] [--record FILE] [--map FILE] [--metrics FILE|-]\n"
+                 "       %s --replay FILE [--workers N] [--metrics FILE|-]\n",
+                 exe, exe);
+}
+} // namespace
+
+int main(int argc, char **argv)
+{
+    folio::demo::DemoOptions opts{};
+    std::string replay_path;
+    std::string metrics_path;
+    size_t workers = 0; // 0 = default
+    for (int i = 1; i < argc; i += 2)
+    {
+        const std::string arg = argv[i];
+        if (i + 1 >= argc)
+        {
+            std::fprintf(stderr, "%s: missing value\n", arg.c_str());
+            usage(argv[0]);
+            return 2;
+        }
+        if (arg == "--seed")
+            opts.seed = std::uint32_t(std::strtoul(argv[i + 1], nullptr, 10));
+        else if (arg == "--record")
+            opts.record_path = argv[i + 1];
+        else if (arg == "--replay")
+            replay_path = argv[i + 1];
+        else if (arg == "--map")
+            opts.map_path = argv[i + 1];
+        else if (arg == "--metrics")
+            metrics_path = argv[i + 1];
+        else if (arg == "--workers")
+            workers = size_t(std::strtoul(argv[i + 1], nullptr, 10));
+        else
+        {
+            std::fprintf(stderr, "unknown option: %s\n", arg.c_str());
+            usage(argv[0]);
+            return 2;
+        }
+    }
+
+    if (!replay_path.empty())
+    {
+        folio::replay::Replayer replay;
+        if (!replay.load(replay_path))
+        {
+            std::fprintf(stderr, "replay: cannot read %s\n", replay_path.c_str());
+            return 1;
+        }
+        opts.replay = &replay;
+        folio::demo::DemoGame game(opts);
+        const double sec = folio::app::runHeadless(game, replay.size(), {}, workers);
+        std::printf("replay: %zu ticks, %.3f ms sim (%.2f us/tick)\n",
+                    replay.size(), sec * 1e3, replay.size() ? sec * 1e6 / double(replay.size()) : 0.0);
+        if (!metrics_path.empty())
+        {
+            // the whole replay as one interval
+            folio::metrics::PeriodicDump(metrics_path, sec).tick(sec);
+        }
+        return game.diverged() ? 1 : 0;
+    }
+
     folio::app::Config cfg{};
     cfg.width = 960;
     cfg.height = 540;
     cfg.title = "folio demo - 2D Open World RPG Game PoC";
     cfg.frame_rate_limit = 120;
+    cfg.metrics_path = metrics_path;
 
     folio::app::GameLoop loop(cfg);
-    folio::demo::DemoGame game;
+    folio::demo::DemoGame game(opts);
     loop.run(game);
     return 0;
 }
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "src/concurrency/job_system.hpp"
 #include <SFML/Window/Event.hpp>
 #include <string>
 
@@ -14,6 +15,8 @@ struct TickRates
 {
     float fixed_delta{1.f / 120.f};
     int max_steps{5};
+    float target_frame{1.f / 120.f}; // 남은 시간만큼 지연 작업(청크 베이크 등)에 예산을 줌
+    float frame_reserve{0.001f};     // display/OS 몫으로 남겨둘 여유
 };
 
 struct Config
@@ -23,12 +26,25 @@ struct Config
     std::string title{"folio demo"};
     int frame_rate_limit{0}; // disable = 0
     bool vsync = false;
+    int workers{0}; // job worker 수, 0 = 코어 수 - 1
+    std::string metrics_path{}; // 비어 있지 않으면 주기적으로 지표를 덤프 ("-" = stderr 텍스트, 그 외 JSON Lines 파일)
+    double metrics_interval{5.0};
+};
+
+// 프레임마다 GameLoop가 지연 작업에 준 예산과 결과
+struct FrameStats
+{
+    double budget_sec{0.0};
+    double render_sec{0.0};
+    concurrency::DrainStats background{};
 };
 
 struct AppContext
 {
     // TODO(jyan): 필요시 입력, 렌더러, 오디오 핸들 등 추가
     sf::RenderWindow *window{nullptr};
+    concurrency::JobSystem *jobs{nullptr};
+    FrameStats frame{};
 };
 
 class Game
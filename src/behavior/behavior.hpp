@@ -0,0 +1,426 @@
+#pragma once
+
+#include "frame_pool.hpp"
+#include "src/core/time.hpp"
+#include "src/core/timing_wheel.hpp"
+#include "src/metrics/metrics.hpp"
+#include <cmath>
+#include <coroutine>
+#include <cstdint>
+#include <exception>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace folio::behavior
+{
+// 행동 스크립트를 코루틴으로. 상태 기계 대신 "windup 기다리고, 때리고, recover 기다리고"를 그대로 씀
+//
+//   Behavior brute(Scheduler &s, Npc &n)       // 매개변수 중 하나는 Scheduler& (프레임을 그 풀에서 받음)
+//   {
+//       for (;;)
+//       {
+//           co_await until([&] { return near(n); }, 8); // 8 tick마다 검사
+//           co_await seconds(f.windup);
+//           strike(n);
+//           co_await seconds(f.recover);
+//       }
+//   }
+//   sched.spawn(brute(sched, npc));
+//
+// 스케줄러는 깨어날 때가 된 코루틴만 resume하므로 tick 비용은 이번 tick의 wake-up 수에 비례
+// (잠든 actor 수와 무관. 대기는 core::TimingWheel에 걸림). 모든 것이 스케줄러를 돌리는 스레드 하나에서 일어남
+class Scheduler;
+class Behavior;
+
+struct BehaviorId
+{
+    std::uint32_t slot{~0u};
+    std::uint32_t gen{0};
+
+    bool valid() const { return slot != ~0u; }
+    friend bool operator==(const BehaviorId &, const BehaviorId &) = default;
+};
+
+namespace detail
+{
+template <typename T, typename... Rest>
+Scheduler &findScheduler(T &first, Rest &...rest)
+{
+    if constexpr (std::is_same_v<std::remove_cv_t<T>, Scheduler>)
+    {
+        return first;
+    }
+    else
+    {
+        static_assert(sizeof...(Rest) > 0, "behavior coroutines must take a behavior::Scheduler& parameter");
+        return findScheduler(rest...);
+    }
+}
+
+struct Promise
+{
+    Scheduler *sched{nullptr};
+    std::uint32_t slot{~0u};
+
+    // 프레임은 매개변수로 받은 스케줄러의 풀에서
+    template <typename... Args>
+    static void *operator new(std::size_t n, Args &...args);
+    static void operator delete(void *p) { FramePool::release(p); }
+
+    Behavior get_return_object();
+    std::suspend_always initial_suspend() noexcept { return {}; } // spawn에서 처음 resume
+    std::suspend_always final_suspend() noexcept { return {}; }   // 스케줄러가 해제
+    void return_void() {}
+    void unhandled_exception() { std::terminate(); } // 행동 스크립트는 예외를 던지지 않음
+};
+
+using Handle = std::coroutine_handle<Promise>;
+} // namespace detail
+
+// 아직 spawn하지 않은 행동. spawn하면 스케줄러가 소유함
+class Behavior
+{
+public:
+    using promise_type = detail::Promise;
+
+    Behavior(Behavior &&o) noexcept : h_(std::exchange(o.h_, {})) {}
+    Behavior &operator=(Behavior &&o) noexcept
+    {
+        if (this != &o)
+        {
+            reset();
+            h_ = std::exchange(o.h_, {});
+        }
+        return *this;
+    }
+    ~Behavior() { reset(); }
+
+private:
+    friend struct detail::Promise;
+    friend class Scheduler;
+    explicit Behavior(detail::Handle h) : h_(h) {}
+    void reset()
+    {
+        if (h_)
+        {
+            h_.destroy();
+            h_ = {};
+        }
+    }
+
+    detail::Handle h_{};
+};
+
+class Event;
+
+class Scheduler
+{
+public:
+    Scheduler() = default;
+    Scheduler(const Scheduler &) = delete;
+    Scheduler &operator=(const Scheduler &) = delete;
+    ~Scheduler()
+    {
+        for (Slot &s : slots_)
+        {
+            if (s.h)
+            {
+                s.h.destroy();
+            }
+        }
+        liveGauge().add(-std::int64_t(live_));
+    }
+
+    FramePool &frames() { return frames_; }
+
+    // 첫 co_await까지 바로 실행. 그 전에 끝나면 invalid id
+    BehaviorId spawn(Behavior b)
+    {
+        std::uint32_t slot;
+        if (!free_.empty())
+        {
+            slot = free_.back();
+            free_.pop_back();
+        }
+        else
+        {
+            slot = std::uint32_t(slots_.size());
+            slots_.emplace_back();
+        }
+        Slot &s = slots_[slot];
+        s.h = std::exchange(b.h_, {});
+        s.h.promise().sched = this;
+        s.h.promise().slot = slot;
+        ++live_;
+        liveGauge().add(1);
+        const BehaviorId id{slot, s.gen};
+        resume(slot);
+        return alive(id) ? id : BehaviorId{};
+    }
+
+    bool alive(BehaviorId id) const { return id.slot < slots_.size() && slots_[id.slot].gen == id.gen && slots_[id.slot].h; }
+
+    // 기다리던 것과 상관없이 바로 해제 (프레임의 지역 변수 소멸자가 돎)
+    // 실행 중인 자기 자신은 안 됨: 스크립트 안에서는 co_return
+    void kill(BehaviorId id)
+    {
+        if (alive(id) && id.slot != running_)
+        {
+            finish(id.slot);
+        }
+    }
+
+    // 고정 스텝마다 한 번. dt는 seconds() 변환에 씀 (다음 tick도 같은 길이라고 봄)
+    // 순서: 이번 tick이 기한인 대기자(휠이 내놓는 순서) -> 지난 tick 이후 signal된 이벤트의 대기자(기다린 순서)
+    void tick(float dt)
+    {
+        static metrics::Counter &resumes = metrics::counter("behavior.resumes");
+        dt_ = dt;
+        // 해제되는 코루틴은 타이머를 cancel하므로 여기 오는 slot은 모두 살아 있음
+        timers_.advance([&](core::TimerId, std::uint32_t slot) {
+            Slot &s = slots_[slot];
+            s.timer = {};
+            if (s.cond && !s.cond(s.cond_ctx))
+            {
+                sleep(slot, s.poll);
+                return;
+            }
+            s.cond = nullptr;
+            resumes.add();
+            resume(slot);
+        });
+        // 여기서 signal된 것은 다음 tick으로
+        ready_batch_.swap(ready_);
+        for (const Wake &w : ready_batch_)
+        {
+            if (current(w))
+            {
+                resumes.add();
+                resume(w.slot);
+            }
+        }
+        ready_batch_.clear();
+    }
+
+    std::uint64_t now() const { return timers_.now(); }
+    float tickDt() const { return dt_; }
+    std::uint32_t live() const { return live_; }
+
+    // 최소 s초가 지나는 tick 수 (1 이상)
+    std::uint64_t ticksFor(float s) const
+    {
+        const float t = std::ceil(s / dt_ - 1e-4f);
+        return t < 1.f ? 1 : std::uint64_t(t);
+    }
+
+    // 아래는 awaiter가 부름: 지금 멈추는 코루틴(slot)을 언제 깨울지
+    void sleep(std::uint32_t slot, std::uint64_t ticks)
+    {
+        slots_[slot].timer = timers_.schedule(ticks, slot);
+    }
+
+    void poll(std::uint32_t slot, bool (*cond)(const void *), const void *ctx, std::uint64_t every)
+    {
+        Slot &s = slots_[slot];
+        s.cond = cond;
+        s.cond_ctx = ctx;
+        s.poll = every < 1 ? 1 : every;
+        sleep(slot, s.poll);
+    }
+
+    // 다음 tick에 깨움 (Event::signal)
+    void wake(std::uint32_t slot)
+    {
+        ready_.push_back(Wake{slot, slots_[slot].gen});
+    }
+
+private:
+    struct Slot
+    {
+        detail::Handle h{};
+        std::uint32_t gen{0};
+        bool (*cond)(const void *){nullptr};
+        const void *cond_ctx{nullptr};
+        std::uint64_t poll{1};
+        core::TimerId timer{}; // 잠들어 있으면 깨울 타이머
+    };
+
+    struct Wake
+    {
+        std::uint32_t slot, gen; // 그 사이 kill되어 slot이 재사용됐으면 gen이 다름
+    };
+
+    static metrics::Gauge &liveGauge()
+    {
+        static metrics::Gauge &g = metrics::gauge("behavior.live");
+        return g;
+    }
+
+    bool current(const Wake &w) const
+    {
+        const Slot &s = slots_[w.slot];
+        return s.h && s.gen == w.gen;
+    }
+
+    void resume(std::uint32_t slot)
+    {
+        const std::uint32_t outer = std::exchange(running_, slot);
+        detail::Handle h = slots_[slot].h;
+        h.resume();
+        running_ = outer;
+        if (h.done())
+        {
+            finish(slot);
+        }
+    }
+
+    void finish(std::uint32_t slot)
+    {
+        Slot &s = slots_[slot];
+        detail::Handle h = std::exchange(s.h, {});
+        ++s.gen;
+        s.cond = nullptr;
+        timers_.cancel(std::exchange(s.timer, {}));
+        h.destroy(); // 대기 중이던 이벤트에서도 빠짐 (awaiter 소멸자)
+        free_.push_back(slot);
+        --live_;
+        liveGauge().add(-1);
+    }
+
+private:
+    FramePool frames_; // slots_보다 먼저 선언: 프레임이 모두 해제된 뒤에 사라짐
+    std::vector<Slot> slots_;
+    std::vector<std::uint32_t> free_;
+    core::TimingWheel<std::uint32_t> timers_; // payload: slot
+    std::vector<Wake> ready_, ready_batch_;
+    float dt_{FixedDelta{}.sec};
+    std::uint32_t running_{~0u};
+    std::uint32_t live_{0};
+};
+
+template <typename... Args>
+void *detail::Promise::operator new(std::size_t n, Args &...args)
+{
+    return findScheduler(args...).frames().allocate(n);
+}
+
+inline Behavior detail::Promise::get_return_object() { return Behavior(Handle::from_promise(*this)); }
+
+// co_await ticks(n): n tick 뒤 (n <= 0이면 멈추지 않음)
+struct ticks
+{
+    std::int64_t n;
+
+    bool await_ready() const { return n <= 0; }
+    void await_suspend(detail::Handle h) const { h.promise().sched->sleep(h.promise().slot, std::uint64_t(n)); }
+    void await_resume() const {}
+};
+
+// co_await seconds(s): s초 이상 지난 첫 tick
+struct seconds
+{
+    float s;
+
+    bool await_ready() const { return s <= 0.f; }
+    void await_suspend(detail::Handle h) const
+    {
+        Scheduler &sched = *h.promise().sched;
+        sched.sleep(h.promise().slot, sched.ticksFor(s));
+    }
+    void await_resume() const {}
+};
+
+// co_await until(pred, every): pred()가 참이 될 때까지. every tick마다 검사하므로 검사 비용은 대기자 수 / every
+template <typename Pred>
+struct until
+{
+    Pred pred;
+    std::int64_t every{1};
+
+    until(Pred p, std::int64_t every_ticks = 1) : pred(std::move(p)), every(every_ticks) {}
+
+    bool await_ready() { return pred(); }
+    void await_suspend(detail::Handle h)
+    {
+        h.promise().sched->poll(h.promise().slot, &check, this, std::uint64_t(every));
+    }
+    void await_resume() const {}
+
+    // awaiter는 대기하는 동안 프레임 안에 있으므로 주소를 넘겨도 됨
+    static bool check(const void *self) { return static_cast<const until *>(self)->pred(); }
+};
+
+// co_await event: 다음 signal()까지. 대기자 목록은 각 프레임 안의 awaiter를 잇는 intrusive list라 할당 없음
+class Event
+{
+public:
+    Event() = default;
+    Event(const Event &) = delete;
+    Event &operator=(const Event &) = delete;
+    ~Event()
+    {
+        // 남은 대기자는 끊어 두기만 함 (깨우지 않음)
+        while (head_)
+        {
+            head_->unlink();
+        }
+    }
+
+    struct Awaiter
+    {
+        Event *ev;
+        Scheduler *sched{nullptr};
+        std::uint32_t slot{~0u};
+        Awaiter *prev{nullptr}, *next{nullptr};
+        bool linked{false};
+
+        explicit Awaiter(Event *e) : ev(e) {}
+        Awaiter(const Awaiter &) = delete;
+        Awaiter &operator=(const Awaiter &) = delete;
+        ~Awaiter() { unlink(); } // kill로 프레임이 사라질 때
+
+        bool await_ready() const { return false; }
+        void await_suspend(detail::Handle h)
+        {
+            sched = h.promise().sched;
+            slot = h.promise().slot;
+            prev = ev->tail_;
+            (prev ? prev->next : ev->head_) = this;
+            ev->tail_ = this;
+            linked = true;
+        }
+        void await_resume() const {}
+
+        void unlink()
+        {
+            if (!linked)
+            {
+                return;
+            }
+            (prev ? prev->next : ev->head_) = next;
+            (next ? next->prev : ev->tail_) = prev;
+            prev = next = nullptr;
+            linked = false;
+        }
+    };
+
+    Awaiter operator co_await() { return Awaiter(this); }
+
+    // 지금 기다리는 코루틴을 모두 다음 tick에 기다린 순서대로 깨움. 기다리는 쪽이 없으면 아무 일도 없음
+    void signal()
+    {
+        while (head_)
+        {
+            Awaiter *a = head_;
+            a->unlink();
+            a->sched->wake(a->slot);
+        }
+    }
+
+    bool waiting() const { return head_ != nullptr; }
+
+private:
+    Awaiter *head_{nullptr}, *tail_{nullptr};
+};
+} // namespace folio::behavior
@@ -0,0 +1,120 @@
+#pragma once
+
+#include "src/metrics/metrics.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <vector>
+
+namespace folio::behavior
+{
+// 코루틴 프레임용 크기 등급별 free list. 블록은 slab 단위로 늘리고 돌려주지 않음
+// 그래서 처음 몇 번 이후의 spawn/종료는 할당 없이 free list만 오감 (resume은 원래 할당이 없음)
+// 블록 앞 16바이트 헤더에 등급과 풀을 적어서 sized delete 없이도 돌려줄 수 있음
+// 한 스레드(스케줄러를 돌리는 쪽)에서만 씀
+class FramePool
+{
+public:
+    static constexpr std::array<std::size_t, 5> kClasses{128, 256, 512, 1024, 2048};
+    static constexpr int kSlabBlocks = 32;
+
+    FramePool() = default;
+    FramePool(const FramePool &) = delete;
+    FramePool &operator=(const FramePool &) = delete;
+    ~FramePool() { bytesGauge().add(-std::int64_t(reserved_)); }
+
+    void *allocate(std::size_t n)
+    {
+        static metrics::Counter &oversized = metrics::counter("behavior.frame_heap");
+        const int c = classOf(n + kHeader);
+        if (c < 0)
+        {
+            // 등급보다 큰 프레임은 그냥 힙에서 (지표로 보고 등급을 늘릴 것)
+            oversized.add();
+            auto *h = static_cast<Header *>(::operator new(n + kHeader));
+            *h = Header{nullptr, -1};
+            return reinterpret_cast<std::byte *>(h) + kHeader;
+        }
+        if (!free_[c])
+        {
+            grow(c);
+        }
+        Block *b = free_[c];
+        free_[c] = b->next;
+        auto *h = reinterpret_cast<Header *>(b);
+        *h = Header{this, c};
+        return reinterpret_cast<std::byte *>(h) + kHeader;
+    }
+
+    static void release(void *p)
+    {
+        auto *h = reinterpret_cast<Header *>(static_cast<std::byte *>(p) - kHeader);
+        if (!h->pool)
+        {
+            ::operator delete(h);
+            return;
+        }
+        FramePool &pool = *h->pool;
+        const int c = h->cls;
+        auto *b = reinterpret_cast<Block *>(h);
+        b->next = pool.free_[c];
+        pool.free_[c] = b;
+    }
+
+    // 잡아둔 slab 전체 바이트 (지표용)
+    std::size_t reserved() const { return reserved_; }
+
+private:
+    struct Header
+    {
+        FramePool *pool;
+        int cls;
+    };
+    struct Block
+    {
+        Block *next;
+    };
+    static constexpr std::size_t kHeader = 16; // 프레임 정렬(__STDCPP_DEFAULT_NEW_ALIGNMENT__) 유지
+    static_assert(sizeof(Header) <= kHeader);
+
+    static metrics::Gauge &bytesGauge()
+    {
+        static metrics::Gauge &g = metrics::gauge("behavior.frame_bytes");
+        return g;
+    }
+
+    static int classOf(std::size_t n)
+    {
+        for (int c = 0; c < int(kClasses.size()); ++c)
+        {
+            if (n <= kClasses[c])
+            {
+                return c;
+            }
+        }
+        return -1;
+    }
+
+    void grow(int c)
+    {
+        const std::size_t size = kClasses[c];
+        slabs_.push_back(std::make_unique<std::byte[]>(size * kSlabBlocks));
+        std::byte *base = slabs_.back().get();
+        for (int i = kSlabBlocks - 1; i >= 0; --i)
+        {
+            auto *b = reinterpret_cast<Block *>(base + size * std::size_t(i));
+            b->next = free_[c];
+            free_[c] = b;
+        }
+        reserved_ += size * kSlabBlocks;
+        bytesGauge().add(std::int64_t(size * kSlabBlocks));
+    }
+
+private:
+    std::array<Block *, kClasses.size()> free_{};
+    std::vector<std::unique_ptr<std::byte[]>> slabs_;
+    std::size_t reserved_{0};
+};
+} // namespace folio::behavior
@@ -0,0 +1,181 @@
+#pragma once
+
+#include "src/concurrency/job_system.hpp"
+#include "src/geometry/types.hpp"
+#include "src/metrics/metrics.hpp"
+#include "src/world/occupancy.hpp"
+#include "src/world/tile_map.hpp"
+#include <cmath>
+#include <limits>
+#include <span>
+
+namespace folio::collision
+{
+using folio::geometry::Vec2;
+
+struct Ray
+{
+    Vec2 origin{};
+    Vec2 dir{};         // 정규화하지 않아도 됨
+    float max_dist{0.f}; // 월드 단위
+};
+
+struct RayHit
+{
+    bool hit{false};
+    int tx{-1}, ty{-1}; // 맞은 타일 (맵 밖이면 경계 바깥 타일)
+    float dist{0.f};    // origin부터 거리. 못 맞으면 max_dist
+    Vec2 point{};
+    Vec2 normal{};      // 들어간 면의 법선. 벽 안에서 시작하면 (0, 0)
+};
+
+namespace detail
+{
+inline metrics::Counter &rayCounter()
+{
+    static metrics::Counter &c = metrics::counter("collision.rays");
+    return c;
+}
+
+// Amanatides-Woo DDA로 벽 타일(맵 밖 포함)까지 진행. 벽이 없는 청크/8x8 블록은 출구까지 한 번에 건너뜀
+inline RayHit castOne(const world::TileMap &map, const world::TileOccupancy &occ, const Ray &ray)
+{
+    RayHit out{};
+    out.dist = ray.max_dist;
+    const Vec2 d = geometry::norm(ray.dir);
+    const Vec2 o = ray.origin;
+    const float ts = float(map.tile_size);
+    const int chunk = occ.chunkTiles();
+    constexpr int kBlock = world::TileOccupancy::kBlock;
+    constexpr float kInf = std::numeric_limits<float>::infinity();
+
+    int tx = int(std::floor(o.x / ts));
+    int ty = int(std::floor(o.y / ts));
+    const auto inside = [&]() { return tx >= 0 && ty >= 0 && tx < map.w && ty < map.h; };
+    const auto solid = [&]() { return !inside() || map.tiles[size_t(ty) * map.w + tx] == 1; };
+    if (solid())
+    {
+        out = RayHit{true, tx, ty, 0.f, o, Vec2{0.f, 0.f}};
+        return out;
+    }
+    if (d.x == 0.f && d.y == 0.f)
+    {
+        out.point = o;
+        return out;
+    }
+
+    const int sx = d.x > 0.f ? 1 : (d.x < 0.f ? -1 : 0);
+    const int sy = d.y > 0.f ? 1 : (d.y < 0.f ? -1 : 0);
+    const float inv_x = sx != 0 ? 1.f / d.x : kInf;
+    const float inv_y = sy != 0 ? 1.f / d.y : kInf;
+    const float delta_x = sx != 0 ? ts * std::abs(inv_x) : kInf;
+    const float delta_y = sy != 0 ? ts * std::abs(inv_y) : kInf;
+    // 타일 i에서 step 방향 경계까지의 t. origin 기준으로 계산해서 건너뛴 뒤에도 오차가 쌓이지 않음
+    const auto boundary = [&](int i, int s, float origin, float inv) {
+        return s == 0 ? kInf : (float(i + (s > 0 ? 1 : 0)) * ts - origin) * inv;
+    };
+
+    float tmx = boundary(tx, sx, o.x, inv_x);
+    float tmy = boundary(ty, sy, o.y, inv_y);
+    float t = 0.f;
+    int axis = 0;
+    for (;;)
+    {
+        // 건너뛸 수 있는 가장 큰 빈 칸 (0 = 타일 하나씩)
+        int cell = 0;
+        if (inside())
+        {
+            if (occ.chunkEmpty(tx / chunk, ty / chunk))
+            {
+                cell = chunk;
+            }
+            else if (occ.blockEmpty(tx / kBlock, ty / kBlock))
+            {
+                cell = kBlock;
+            }
+        }
+        if (cell > 0)
+        {
+            // 이 칸의 마지막 열/행을 벗어나는 t 중 작은 쪽으로 나감
+            const int lx0 = tx / cell * cell, lx1 = std::min(map.w, lx0 + cell) - 1;
+            const int ly0 = ty / cell * cell, ly1 = std::min(map.h, ly0 + cell) - 1;
+            const float ex = boundary(sx > 0 ? lx1 : lx0, sx, o.x, inv_x);
+            const float ey = boundary(sy > 0 ? ly1 : ly0, sy, o.y, inv_y);
+            if (ex < ey)
+            {
+                t = ex;
+                axis = 0;
+                tx = (sx > 0 ? lx1 : lx0) + sx;
+                ty = std::clamp(int(std::floor((o.y + d.y * t) / ts)), ly0, ly1);
+            }
+            else
+            {
+                t = ey;
+                axis = 1;
+                ty = (sy > 0 ? ly1 : ly0) + sy;
+                tx = std::clamp(int(std::floor((o.x + d.x * t) / ts)), lx0, lx1);
+            }
+            tmx = boundary(tx, sx, o.x, inv_x);
+            tmy = boundary(ty, sy, o.y, inv_y);
+        }
+        else if (tmx < tmy)
+        {
+            t = tmx;
+            axis = 0;
+            tx += sx;
+            tmx += delta_x;
+        }
+        else
+        {
+            t = tmy;
+            axis = 1;
+            ty += sy;
+            tmy += delta_y;
+        }
+
+        if (t > ray.max_dist)
+        {
+            out.point = o + d * ray.max_dist;
+            return out;
+        }
+        if (solid())
+        {
+            out.hit = true;
+            out.tx = tx;
+            out.ty = ty;
+            out.dist = t;
+            out.point = o + d * t;
+            out.normal = axis == 0 ? Vec2{float(-sx), 0.f} : Vec2{0.f, float(-sy)};
+            return out;
+        }
+    }
+}
+} // namespace detail
+
+inline RayHit raycast(const world::TileMap &map, const world::TileOccupancy &occ, const Ray &ray)
+{
+    detail::rayCounter().add();
+    return detail::castOne(map, occ, ray);
+}
+
+// N개를 한 번에. hits.size() >= rays.size()
+inline void raycast(const world::TileMap &map, const world::TileOccupancy &occ,
+                    std::span<const Ray> rays, std::span<RayHit> hits)
+{
+    detail::rayCounter().add(rays.size());
+    for (size_t i = 0; i < rays.size(); ++i)
+    {
+        hits[i] = detail::castOne(map, occ, rays[i]);
+    }
+}
+
+// 워커에 grain개씩 나눠서. 맵과 occupancy는 호출이 끝날 때까지 바뀌면 안 됨
+inline void raycast(const world::TileMap &map, const world::TileOccupancy &occ,
+                    std::span<const Ray> rays, std::span<RayHit> hits,
+                    concurrency::JobSystem &jobs, int grain = 256)
+{
+    jobs.parallelFor(0, int(rays.size()), grain, [&](int lo, int hi) {
+        raycast(map, occ, rays.subspan(size_t(lo), size_t(hi - lo)), hits.subspan(size_t(lo), size_t(hi - lo)));
+    });
+}
+} // namespace folio::collision
@@ -1,34 +1,107 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <chrono>
+#include <condition_variable>
 #include <deque>
 #include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 namespace folio::concurrency
 {
+// 지연 작업 우선순위. 값이 작을수록 먼저 실행됨
+enum class Priority
+{
+    Visible,     // 화면에 보이는 청크 베이크 등, 늦으면 바로 티가 나는 작업
+    Prefetch,    // 곧 필요해질 작업 (화면 밖 여유 영역)
+    Housekeeping // 정리/통계 등 언제 해도 되는 작업
+};
+constexpr size_t kPriorityCount = 3;
+
+struct DrainStats
+{
+    size_t ran{0};
+    std::array<size_t, kPriorityCount> deferred{}; // drain 후 남은 작업 수 (우선순위별)
+    double spent_sec{0.0};
+
+    size_t deferredTotal() const { return deferred[0] + deferred[1] + deferred[2]; }
+};
+
+inline size_t defaultWorkerCount()
+{
+    const unsigned hw = std::thread::hardware_concurrency();
+    return hw > 1 ? size_t(hw - 1) : size_t(1);
+}
+
 class JobSystem
 {
 public:
     using Job = std::function<void()>;
 
-    explicit JobSystem(size_t workers) {}
-    ~JobSystem() = default;
+    explicit JobSystem(size_t workers)
+    {
+        threads_.reserve(workers);
+        for (size_t i = 0; i < workers; ++i)
+        {
+            threads_.emplace_back([this]() { workerLoop(); });
+        }
+    }
+    ~JobSystem()
+    {
+        {
+            std::lock_guard<std::mutex> lock(work_mutex_);
+            stop_ = true;
+        }
+        work_cv_.notify_all();
+        for (auto &t : threads_)
+        {
+            t.join();
+        }
+    }
+
+    JobSystem(const JobSystem &) = delete;
+    JobSystem &operator=(const JobSystem &) = delete;
 
-    void submit(Job j)
+    // 지연 작업: drain()을 호출한 스레드(메인)에서 우선순위 순으로 실행됨
+    void submit(Job j, Priority p = Priority::Visible)
     {
-        queue_.emplace_back(std::move(j));
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        queues_[size_t(p)].emplace_back(std::move(j));
     }
 
-    void drain(double budget_sec = 0.0)
+    // budget_sec 동안 lowest 이하 우선순위의 작업을 실행 (0 = 무제한)
+    // 예산이 있으면 최소 한 개는 실행하므로 예산이 바닥나도 진행은 멈추지 않음
+    DrainStats drain(double budget_sec = 0.0, Priority lowest = Priority::Housekeeping)
     {
         using clock = std::chrono::steady_clock;
         const auto start = clock::now();
 
-        while (!queue_.empty())
+        DrainStats stats{};
+        for (;;)
         {
-            auto job = std::move(queue_.front());
-            queue_.pop_front();
+            Job job;
+            {
+                std::lock_guard<std::mutex> lock(queue_mutex_);
+                for (size_t p = 0; p <= size_t(lowest); ++p)
+                {
+                    if (!queues_[p].empty())
+                    {
+                        job = std::move(queues_[p].front());
+                        queues_[p].pop_front();
+                        break;
+                    }
+                }
+            }
+            if (!job)
+            {
+                break;
+            }
             job();
+            ++stats.ran;
 
             if (budget_sec > 0.0)
             {
@@ -39,11 +112,127 @@ public:
                 }
             }
         }
+
+        stats.spent_sec = std::chrono::duration<double>(clock::now() - start).count();
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        for (size_t p = 0; p < kPriorityCount; ++p)
+        {
+            stats.deferred[p] = queues_[p].size();
+        }
+        return stats;
+    }
+
+    size_t pending() const
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        return queues_[0].size() + queues_[1].size() + queues_[2].size();
+    }
+
+    size_t pending(Priority p) const
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        return queues_[size_t(p)].size();
+    }
+
+    // 병렬 작업: 워커 스레드에서 바로 실행됨 (워커가 없으면 wait 중인 스레드가 처리)
+    void dispatch(Job j)
+    {
+        {
+            std::lock_guard<std::mutex> lock(work_mutex_);
+            work_.emplace_back(std::move(j));
+        }
+        work_cv_.notify_one();
+    }
+
+    // 워커 큐에서 작업 하나를 꺼내 현재 스레드에서 실행. 실행했으면 true
+    bool runOne()
+    {
+        Job job;
+        {
+            std::lock_guard<std::mutex> lock(work_mutex_);
+            if (work_.empty())
+            {
+                return false;
+            }
+            job = std::move(work_.front());
+            work_.pop_front();
+        }
+        job();
+        return true;
+    }
+
+    // counter가 0이 될 때까지 워커 큐를 도우면서 대기
+    void waitFor(const std::atomic<int> &counter)
+    {
+        while (counter.load(std::memory_order_acquire) > 0)
+        {
+            if (!runOne())
+            {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    // [begin, end)를 grain 크기 구간으로 나눠 fn(lo, hi)를 병렬 실행. 모두 끝나면 반환
+    template <typename Fn>
+    void parallelFor(int begin, int end, int grain, Fn &&fn)
+    {
+        if (end <= begin)
+        {
+            return;
+        }
+        grain = std::max(1, grain);
+        const int count = (end - begin + grain - 1) / grain;
+        if (count == 1 || threads_.empty())
+        {
+            fn(begin, end);
+            return;
+        }
+
+        std::atomic<int> remaining{count - 1};
+        for (int i = 1; i < count; ++i)
+        {
+            const int lo = begin + i * grain;
+            const int hi = std::min(end, lo + grain);
+            dispatch([&fn, &remaining, lo, hi]() {
+                fn(lo, hi);
+                remaining.fetch_sub(1, std::memory_order_acq_rel);
+            });
+        }
+        fn(begin, std::min(end, begin + grain));
+        waitFor(remaining);
     }
 
-    size_t pending() const { return queue_.size(); }
+    size_t workerCount() const { return threads_.size(); }
 
 private:
-    std::deque<Job> queue_;
+    void workerLoop()
+    {
+        for (;;)
+        {
+            Job job;
+            {
+                std::unique_lock<std::mutex> lock(work_mutex_);
+                work_cv_.wait(lock, [this]() { return stop_ || !work_.empty(); });
+                if (work_.empty())
+                {
+                    return;
+                }
+                job = std::move(work_.front());
+                work_.pop_front();
+            }
+            job();
+        }
+    }
+
+private:
+    mutable std::mutex queue_mutex_;
+    std::array<std::deque<Job>, kPriorityCount> queues_;
+
+    std::mutex work_mutex_;
+    std::condition_variable work_cv_;
+    std::deque<Job> work_;
+    bool stop_{false};
+    std::vector<std::thread> threads_;
 };
-} // namespace folio::concurrency
\ No newline at end of file
+} // namespace folio::concurrency
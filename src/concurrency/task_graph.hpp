@@ -0,0 +1,132 @@
+#pragma once
+
+#include "job_system.hpp"
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace folio::concurrency
+{
+// 의존성을 가진 작업 그래프. 한 번 구성해 두고 매 tick run()으로 재실행한다.
+// 선행 작업이 모두 끝난 작업은 마지막 선행 작업을 끝낸 스레드가 이어서 실행(continuation)한다.
+class TaskGraph
+{
+public:
+    using TaskId = size_t;
+    using Task = std::function<void()>;
+
+    TaskId add(Task fn)
+    {
+        nodes_.push_back(Node{std::move(fn), {}, 0});
+        return nodes_.size() - 1;
+    }
+
+    // before가 끝난 뒤에 after가 실행됨
+    void precede(TaskId before, TaskId after)
+    {
+        nodes_[before].successors.push_back(after);
+        ++nodes_[after].deps;
+    }
+
+    // before 완료 시 이어서 실행할 작업 추가
+    TaskId then(TaskId before, Task fn)
+    {
+        const TaskId id = add(std::move(fn));
+        precede(before, id);
+        return id;
+    }
+
+    void clear()
+    {
+        nodes_.clear();
+        remaining_.reset();
+        capacity_ = 0;
+    }
+
+    size_t size() const { return nodes_.size(); }
+
+    // 그래프 전체를 실행하고 모든 작업이 끝나면 반환. 호출 스레드도 작업을 처리함
+    // 순환 의존성은 검사하지 않음 (순환이 있으면 끝나지 않음)
+    void run(JobSystem &jobs)
+    {
+        if (nodes_.empty())
+        {
+            return;
+        }
+        if (capacity_ < nodes_.size())
+        {
+            capacity_ = nodes_.size();
+            remaining_ = std::make_unique<std::atomic<int>[]>(capacity_);
+        }
+        for (size_t i = 0; i < nodes_.size(); ++i)
+        {
+            remaining_[i].store(nodes_[i].deps, std::memory_order_relaxed);
+        }
+
+        std::atomic<int> left{int(nodes_.size())};
+        TaskId first = kNone;
+        for (TaskId i = 0; i < nodes_.size(); ++i)
+        {
+            if (nodes_[i].deps != 0)
+            {
+                continue;
+            }
+            if (first == kNone)
+            {
+                first = i;
+                continue;
+            }
+            jobs.dispatch([this, &jobs, &left, i]() { execute(jobs, left, i); });
+        }
+        if (first != kNone)
+        {
+            execute(jobs, left, first);
+        }
+        jobs.waitFor(left);
+    }
+
+private:
+    static constexpr TaskId kNone = ~TaskId(0);
+
+    struct Node
+    {
+        Task fn;
+        std::vector<TaskId> successors;
+        int deps{0};
+    };
+
+    void execute(JobSystem &jobs, std::atomic<int> &left, TaskId id)
+    {
+        while (id != kNone)
+        {
+            nodes_[id].fn();
+
+            // 준비된 첫 후속 작업은 현재 스레드에서 이어서 실행, 나머지는 워커로
+            TaskId next = kNone;
+            for (TaskId succ : nodes_[id].successors)
+            {
+                if (remaining_[succ].fetch_sub(1, std::memory_order_acq_rel) != 1)
+                {
+                    continue;
+                }
+                if (next == kNone)
+                {
+                    next = succ;
+                }
+                else
+                {
+                    jobs.dispatch([this, &jobs, &left, succ]() { execute(jobs, left, succ); });
+                }
+            }
+            left.fetch_sub(1, std::memory_order_acq_rel);
+            id = next;
+        }
+    }
+
+private:
+    std::vector<Node> nodes_;
+    std::unique_ptr<std::atomic<int>[]> remaining_;
+    size_t capacity_{0};
+};
+} // namespace folio::concurrency
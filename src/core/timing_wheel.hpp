@@ -0,0 +1,240 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace folio::core
+{
+struct TimerId
+{
+    std::uint32_t index{~0u};
+    std::uint32_t gen{0};
+
+    bool valid() const { return index != ~0u; }
+    friend bool operator==(const TimerId &, const TimerId &) = default;
+};
+
+// 고정 스텝 tick 번호로 도는 계층형 타이밍 휠 (256칸 x 4단, 2^32 tick 안쪽. 그 너머는 맨 위 단에서 기다렸다 다시 넣음)
+// schedule/cancel은 O(1), advance는 이번 tick에 끝나는 타이머 수 + 가끔의 cascade에 비례
+// 그래서 오래 기다리는 타이머가 아무리 많아도 tick마다 드는 비용은 거의 없음
+// 같은 tick에 끝나는 타이머는 한 번에 부름 (같은 단에서 내려온 것끼리는 건 순서, 전체 순서도 결정적). 한 스레드에서만 씀
+//
+//   wheel.schedule(ticks, payload)          // ticks 뒤 한 번
+//   wheel.schedule(ticks, payload, period)  // ticks 뒤, 이후 period마다 (cancel까지)
+//   wheel.advance([](TimerId id, const T &payload) { ... });  // 매 tick
+template <typename T>
+class TimingWheel
+{
+public:
+    static constexpr int kLevelBits = 8;
+    static constexpr int kSlots = 1 << kLevelBits;
+    static constexpr int kLevels = 4;
+
+    // start: 처음 now() (이어서 돌리는 시뮬레이션의 tick 번호 등)
+    explicit TimingWheel(std::uint64_t start = 0) : now_(start)
+    {
+        heads_.fill(kNil);
+        tails_.fill(kNil);
+    }
+
+    // 마지막으로 advance한 tick
+    std::uint64_t now() const { return now_; }
+    std::uint32_t size() const { return size_; }
+
+    // delay tick 뒤 (0이면 다음 tick). period > 0이면 그 뒤로 period마다 반복
+    TimerId schedule(std::uint64_t delay, T payload, std::uint32_t period = 0)
+    {
+        std::uint32_t i;
+        if (free_ != kNil)
+        {
+            i = free_;
+            free_ = nodes_[i].next;
+        }
+        else
+        {
+            i = std::uint32_t(nodes_.size());
+            nodes_.emplace_back();
+        }
+        Node &n = nodes_[i];
+        n.expires = now_ + (delay < 1 ? 1 : delay);
+        n.period = period;
+        n.payload = std::move(payload);
+        n.state = State::Pending;
+        place(i);
+        ++size_;
+        return TimerId{i, n.gen};
+    }
+
+    // 걸려 있거나 지금 불리는 중 (불리는 중에 cancel된 것은 아님)
+    bool pending(TimerId id) const
+    {
+        if (id.index >= nodes_.size() || nodes_[id.index].gen != id.gen)
+        {
+            return false;
+        }
+        const State st = nodes_[id.index].state;
+        return st == State::Pending || st == State::Firing;
+    }
+
+    // 다음에 끝나기까지 남은 tick (없으면 0)
+    std::uint64_t remaining(TimerId id) const { return pending(id) ? nodes_[id.index].expires - now_ : 0; }
+
+    // 콜백 안에서 불러도 됨 (자기 자신 포함). 없는 타이머면 false
+    bool cancel(TimerId id)
+    {
+        if (!pending(id))
+        {
+            return false;
+        }
+        Node &n = nodes_[id.index];
+        if (n.state == State::Pending)
+        {
+            unlink(id.index);
+            release(id.index);
+        }
+        else
+        {
+            n.state = State::Cancelled; // 지금 불리는 중: 콜백이 끝나면 해제
+        }
+        --size_;
+        return true;
+    }
+
+    // 한 tick 진행하고 이번 tick에 끝난 타이머마다 fn(TimerId, const T &payload)
+    // payload는 복사본 (콜백이 schedule하면 저장소가 옮겨질 수 있음)
+    // 콜백에서 새로 건 타이머는 빨라도 다음 tick에 끝나므로 이번 묶음에 끼지 않음
+    template <typename Fn>
+    void advance(Fn &&fn)
+    {
+        ++now_;
+        // 아래 단의 칸이 한 바퀴 돌 때마다 윗단의 다음 칸을 풀어서 내림
+        for (int level = 1; level < kLevels; ++level)
+        {
+            if (((now_ >> ((level - 1) * kLevelBits)) & (kSlots - 1)) != 0)
+            {
+                break;
+            }
+            cascade(level, int((now_ >> (level * kLevelBits)) & (kSlots - 1)));
+        }
+        const int slot = int(now_ & (kSlots - 1));
+        while (heads_[slot] != kNil)
+        {
+            const std::uint32_t i = heads_[slot];
+            unlink(i);
+            nodes_[i].state = State::Firing;
+            const TimerId id{i, nodes_[i].gen};
+            const T payload = nodes_[i].payload;
+            fn(id, payload);
+            Node &after = nodes_[i];
+            if (after.state == State::Cancelled)
+            {
+                release(i);
+            }
+            else if (after.period > 0)
+            {
+                after.expires = now_ + after.period;
+                after.state = State::Pending;
+                place(i);
+            }
+            else
+            {
+                release(i);
+                --size_;
+            }
+        }
+    }
+
+private:
+    static constexpr std::uint32_t kNil = ~0u;
+
+    enum class State : std::uint8_t
+    {
+        Free,
+        Pending,
+        Firing,
+        Cancelled // 불리는 중에 cancel됨
+    };
+
+    struct Node
+    {
+        std::uint64_t expires{0};
+        std::uint32_t period{0};
+        std::uint32_t gen{0};
+        std::uint32_t prev{kNil}, next{kNil}; // 칸 안의 목록. Free면 next가 free list
+        std::uint16_t bucket{0};              // level * kSlots + slot
+        State state{State::Free};
+        T payload{};
+    };
+
+    // expires와 now_가 처음 갈리는 단에 넣음. 맨 위 단은 한 바퀴(2^32 tick)를 돌아 쓰므로
+    // 남은 시간이 한 바퀴 안이면 expires의 칸에, 더 멀면 한 바퀴 뒤에 풀리는 칸(현재 칸 바로 앞)에서 기다렸다 다시 넣음
+    void place(std::uint32_t i)
+    {
+        Node &n = nodes_[i];
+        int bucket = -1;
+        for (int level = 0; level < kLevels - 1; ++level)
+        {
+            const int above = (level + 1) * kLevelBits;
+            if ((n.expires >> above) == (now_ >> above))
+            {
+                bucket = level * kSlots + int((n.expires >> (level * kLevelBits)) & (kSlots - 1));
+                break;
+            }
+        }
+        if (bucket < 0)
+        {
+            const int top = (kLevels - 1) * kLevelBits;
+            const std::uint64_t span = std::uint64_t(1) << (kLevels * kLevelBits);
+            const std::uint64_t at = n.expires - now_ < span ? (n.expires >> top) : (now_ >> top) + kSlots - 1;
+            bucket = (kLevels - 1) * kSlots + int(at & (kSlots - 1));
+        }
+        n.bucket = std::uint16_t(bucket);
+        n.next = kNil;
+        n.prev = tails_[bucket];
+        (n.prev != kNil ? nodes_[n.prev].next : heads_[bucket]) = i;
+        tails_[bucket] = i;
+    }
+
+    void unlink(std::uint32_t i)
+    {
+        Node &n = nodes_[i];
+        (n.prev != kNil ? nodes_[n.prev].next : heads_[n.bucket]) = n.next;
+        (n.next != kNil ? nodes_[n.next].prev : tails_[n.bucket]) = n.prev;
+        n.prev = n.next = kNil;
+    }
+
+    void release(std::uint32_t i)
+    {
+        Node &n = nodes_[i];
+        n.state = State::Free;
+        n.payload = T{};
+        ++n.gen;
+        n.next = free_;
+        free_ = i;
+    }
+
+    // 칸을 통째로 떼어서 건 순서대로 다시 넣음 (이제 now_와 가까워져서 아래 단으로 감)
+    void cascade(int level, int slot)
+    {
+        const int bucket = level * kSlots + slot;
+        std::uint32_t i = heads_[bucket];
+        heads_[bucket] = tails_[bucket] = kNil;
+        while (i != kNil)
+        {
+            const std::uint32_t next = nodes_[i].next;
+            place(i);
+            i = next;
+        }
+    }
+
+private:
+    std::vector<Node> nodes_;
+    std::array<std::uint32_t, kSlots * kLevels> heads_{};
+    std::array<std::uint32_t, kSlots * kLevels> tails_{};
+    std::uint32_t free_{kNil};
+    std::uint32_t size_{0};
+    std::uint64_t now_{0};
+};
+} // namespace folio::core
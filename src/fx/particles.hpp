@@ -0,0 +1,255 @@
+#pragma once
+
+#include "src/geometry/types.hpp"
+#include "src/metrics/metrics.hpp"
+#include <SFML/Graphics/Color.hpp>
+#include <SFML/Graphics/Vertex.hpp>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define FOLIO_FX_SSE2 1
+#endif
+
+namespace folio::fx
+{
+using geometry::Vec2;
+
+// 파티클 종류별 공통 값. 파티클에는 인덱스만 저장
+struct ParticleStyle
+{
+    sf::Color color0{255, 255, 255, 255}; // 생성 시
+    sf::Color color1{255, 255, 255, 0};   // 수명 끝
+    float size0{4.f}, size1{1.f};         // 한 변 (월드 단위)
+    float drag{0.f};                      // 초당 감속 비율 (0 = 없음)
+    float gravity{0.f};                   // +y 방향 가속
+};
+
+// 한 번에 뿌리는 방식. dir 기준 +-spread(rad) 안의 무작위 방향
+struct Emitter
+{
+    Vec2 pos{};
+    Vec2 dir{1.f, 0.f};
+    float spread{3.14159265f};
+    float radius{0.f}; // 생성 위치 흩뿌림
+    float speed_min{20.f}, speed_max{60.f};
+    float life_min{0.2f}, life_max{0.5f};
+    std::uint8_t style{0};
+};
+
+// 고정 용량 SoA 풀. 생성은 끝에 추가, 죽은 파티클은 마지막 것과 바꿔 제거 (순서는 유지하지 않음)
+// update는 고정 스텝에서, appendVertices는 프레임마다. 할당은 생성자에서만
+class ParticlePool
+{
+public:
+    static constexpr int kMaxStyles = 16;
+    static constexpr std::uint8_t kInvalidStyle = 0xff;
+
+    explicit ParticlePool(int capacity, std::uint32_t seed = 0x9e3779b9u)
+        : capacity_(capacity), rng_(seed ? seed : 1u)
+    {
+        const size_t n = size_t(capacity);
+        for (auto *a : {&px_, &py_, &vx_, &vy_, &age_, &life_})
+        {
+            a->assign(n, 0.f);
+        }
+        style_.assign(n, 0);
+    }
+
+    int size() const { return size_; }
+    int capacity() const { return capacity_; }
+    void clear() { size_ = 0; }
+
+    // 등록 순서가 style 인덱스. 표가 차 있으면 kInvalidStyle (기존 style은 건드리지 않음)
+    std::uint8_t addStyle(const ParticleStyle &s)
+    {
+        if (styles_count_ >= kMaxStyles)
+        {
+            return kInvalidStyle;
+        }
+        styles_[styles_count_] = s;
+        return std::uint8_t(styles_count_++);
+    }
+
+    // count개 생성. 풀이 차면 남은 만큼만. 실제로 만든 수를 돌려줌 (style이 kInvalidStyle이면 0)
+    int emit(const Emitter &e, int count)
+    {
+        if (e.style >= kMaxStyles)
+        {
+            return 0;
+        }
+        const int n = std::min(count, capacity_ - size_);
+        const float base = std::atan2(e.dir.y, e.dir.x);
+        for (int k = 0; k < n; ++k)
+        {
+            const int i = size_++;
+            const float a = base + e.spread * (2.f * unit() - 1.f);
+            const float speed = e.speed_min + (e.speed_max - e.speed_min) * unit();
+            const float r = e.radius * unit();
+            const float ra = 6.2831853f * unit();
+            px_[i] = e.pos.x + r * std::cos(ra);
+            py_[i] = e.pos.y + r * std::sin(ra);
+            vx_[i] = std::cos(a) * speed;
+            vy_[i] = std::sin(a) * speed;
+            age_[i] = 0.f;
+            life_[i] = e.life_min + (e.life_max - e.life_min) * unit();
+            style_[i] = e.style;
+        }
+        return n;
+    }
+
+    // 적분 + 나이 증가 후 수명이 다한 것 제거
+    void update(float dt)
+    {
+        static metrics::Gauge &live = metrics::gauge("fx.particles");
+        // 모든 종류의 drag/gravity가 같으면 한 번에 SIMD로, 아니면 종류별 계수 표로
+        if (uniformMotion())
+        {
+            integrate(0, size_, 1.f - std::min(1.f, styles_[0].drag * dt), styles_[0].gravity * dt, dt);
+        }
+        else
+        {
+            integrateStyled(dt);
+        }
+        compact();
+        live.set(size_);
+    }
+
+    // 파티클 하나당 사각형 하나(Triangles, 6정점)를 out 끝에 추가
+    // project: 월드 좌표 -> 그릴 좌표 (보통 projection.toScreen)
+    template <typename Project>
+    void appendVertices(std::vector<sf::Vertex> &out, Project &&project) const
+    {
+        const size_t base = out.size();
+        out.resize(base + size_t(size_) * 6);
+        sf::Vertex *dst = out.data() + base;
+        for (int i = 0; i < size_; ++i)
+        {
+            const ParticleStyle &s = styles_[style_[i]];
+            const float t = std::min(1.f, age_[i] / life_[i]);
+            const float h = 0.5f * (s.size0 + (s.size1 - s.size0) * t);
+            const sf::Color c = lerp(s.color0, s.color1, t);
+            const Vec2 p = project(Vec2{px_[i], py_[i]});
+            const sf::Vector2f lt{p.x - h, p.y - h}, rt{p.x + h, p.y - h}, rb{p.x + h, p.y + h}, lb{p.x - h, p.y + h};
+            dst[0] = sf::Vertex{lt, c};
+            dst[1] = sf::Vertex{rt, c};
+            dst[2] = sf::Vertex{rb, c};
+            dst[3] = sf::Vertex{lt, c};
+            dst[4] = sf::Vertex{rb, c};
+            dst[5] = sf::Vertex{lb, c};
+            dst += 6;
+        }
+    }
+
+private:
+    bool uniformMotion() const
+    {
+        for (int s = 1; s < styles_count_; ++s)
+        {
+            if (styles_[s].drag != styles_[0].drag || styles_[s].gravity != styles_[0].gravity)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // [lo, hi): v = v * damp + (0, gy), p += v * dt, age += dt
+    void integrate(int lo, int hi, float damp, float gy, float dt)
+    {
+        int i = lo;
+#if FOLIO_FX_SSE2
+        const __m128 d = _mm_set1_ps(damp);
+        const __m128 g = _mm_set1_ps(gy);
+        const __m128 t = _mm_set1_ps(dt);
+        for (; i + 4 <= hi; i += 4)
+        {
+            const __m128 vx = _mm_mul_ps(_mm_loadu_ps(&vx_[i]), d);
+            const __m128 vy = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(&vy_[i]), d), g);
+            _mm_storeu_ps(&vx_[i], vx);
+            _mm_storeu_ps(&vy_[i], vy);
+            _mm_storeu_ps(&px_[i], _mm_add_ps(_mm_loadu_ps(&px_[i]), _mm_mul_ps(vx, t)));
+            _mm_storeu_ps(&py_[i], _mm_add_ps(_mm_loadu_ps(&py_[i]), _mm_mul_ps(vy, t)));
+            _mm_storeu_ps(&age_[i], _mm_add_ps(_mm_loadu_ps(&age_[i]), t));
+        }
+#endif
+        for (; i < hi; ++i)
+        {
+            step(i, damp, gy, dt);
+        }
+    }
+
+    void integrateStyled(float dt)
+    {
+        std::array<float, kMaxStyles> damp{}, gy{};
+        for (int s = 0; s < styles_count_; ++s)
+        {
+            damp[s] = 1.f - std::min(1.f, styles_[s].drag * dt);
+            gy[s] = styles_[s].gravity * dt;
+        }
+        for (int i = 0; i < size_; ++i)
+        {
+            step(i, damp[style_[i]], gy[style_[i]], dt);
+        }
+    }
+
+    void step(int i, float damp, float gy, float dt)
+    {
+        vx_[i] *= damp;
+        vy_[i] = vy_[i] * damp + gy;
+        px_[i] += vx_[i] * dt;
+        py_[i] += vy_[i] * dt;
+        age_[i] += dt;
+    }
+
+    // swap-remove: 죽은 자리에 마지막 파티클을 옮김
+    void compact()
+    {
+        int i = 0;
+        while (i < size_)
+        {
+            if (age_[i] < life_[i])
+            {
+                ++i;
+                continue;
+            }
+            const int last = --size_;
+            px_[i] = px_[last];
+            py_[i] = py_[last];
+            vx_[i] = vx_[last];
+            vy_[i] = vy_[last];
+            age_[i] = age_[last];
+            life_[i] = life_[last];
+            style_[i] = style_[last];
+        }
+    }
+
+    static sf::Color lerp(sf::Color a, sf::Color b, float t)
+    {
+        const auto mix = [t](std::uint8_t x, std::uint8_t y) { return std::uint8_t(float(x) + (float(y) - float(x)) * t); };
+        return sf::Color(mix(a.r, b.r), mix(a.g, b.g), mix(a.b, b.b), mix(a.a, b.a));
+    }
+
+    // [0, 1)
+    float unit()
+    {
+        rng_ ^= rng_ << 13;
+        rng_ ^= rng_ >> 17;
+        rng_ ^= rng_ << 5;
+        return float(rng_ >> 8) * (1.f / 16777216.f);
+    }
+
+private:
+    int capacity_;
+    int size_{0};
+    std::uint32_t rng_;
+    std::vector<float> px_, py_, vx_, vy_, age_, life_;
+    std::vector<std::uint8_t> style_;
+    std::array<ParticleStyle, kMaxStyles> styles_{};
+    int styles_count_{0}; // 0이면 기본 ParticleStyle
+};
+} // namespace folio::fx
@@ -0,0 +1,113 @@
+#pragma once
+
+#include "types.hpp"
+#include <algorithm>
+#include <concepts>
+
+namespace folio::geometry
+{
+// 월드(픽셀 단위 평면 좌표) <-> 화면(그리는 좌표) 투영
+// 청크 컬링/베이크, 마우스 picking, 이동 방향 변환이 모두 이 타입을 템플릿 인자로 받아서
+// 투영마다 컴파일 시점에 특수화됨 (핫 루프에 런타임 분기 없음)
+// 새 투영은 아핀 변환이기만 하면 아래 concept을 만족하는 타입 하나로 충분
+template <typename P>
+concept ScreenProjection = requires(const P &p, const Vec2 &v) {
+    { p.toScreen(v) } -> std::same_as<Vec2>;
+    { p.toWorld(v) } -> std::same_as<Vec2>;
+    { p.screenDirToWorld(v) } -> std::same_as<Vec2>;
+    { p.tileSize() } -> std::convertible_to<int>;
+};
+
+struct TopDownProjection
+{
+    int tile_size{32};
+
+    TopDownProjection() = default;
+    explicit TopDownProjection(int ts) : tile_size(ts) {}
+
+    int tileSize() const { return tile_size; }
+    Vec2 toScreen(const Vec2 &w) const { return w; }
+    Vec2 toWorld(const Vec2 &s) const { return s; }
+    Vec2 screenDirToWorld(const Vec2 &d) const { return norm(d); }
+};
+
+struct IsoDims
+{
+    float w{64.f}; // diamond width in pixels
+    float h{32.f}; // diamond height in pixels
+};
+
+// 타일 (1, 0)이 화면 (w/2, h/2), (0, 1)이 (-w/2, h/2)로 가는 다이아몬드 투영
+struct IsoProjection
+{
+    int tile_size{32};
+    IsoDims dims{64.f, 32.f};
+
+    IsoProjection() = default;
+    // 기본은 2:1 다이아몬드 (w = 2 * tile_size, h = tile_size)
+    explicit IsoProjection(int ts) : tile_size(ts), dims{float(ts * 2), float(ts)} {}
+    IsoProjection(int ts, IsoDims d) : tile_size(ts), dims(d) {}
+
+    int tileSize() const { return tile_size; }
+
+    Vec2 toScreen(const Vec2 &w) const
+    {
+        const float fx = w.x / float(tile_size);
+        const float fy = w.y / float(tile_size);
+        const float sx = dims.w * 0.5f;
+        const float sy = dims.h * 0.5f;
+        return {(fx - fy) * sx, (fx + fy) * sy};
+    }
+
+    Vec2 toWorld(const Vec2 &s) const
+    {
+        const float sx = dims.w * 0.5f;
+        const float sy = dims.h * 0.5f;
+        const float fx = (s.x / sx + s.y / sy) * 0.5f;
+        const float fy = (s.y / sy - s.x / sx) * 0.5f;
+        return {fx * float(tile_size), fy * float(tile_size)};
+    }
+
+    // 화면 방향 -> 월드 방향 (정규화). 화면에서 같은 속도로 보이도록
+    Vec2 screenDirToWorld(const Vec2 &d) const
+    {
+        const float sx = dims.w * 0.5f;
+        const float sy = dims.h * 0.5f;
+        return norm(Vec2{0.5f * (d.x / sx + d.y / sy), 0.5f * (-d.x / sx + d.y / sy)});
+    }
+};
+
+// 월드 사각형 [0, world_w) x [0, world_h)를 덮는 화면 사각형
+template <ScreenProjection P>
+AABB screenBounds(const P &proj, float world_w, float world_h)
+{
+    const Vec2 c[4] = {proj.toScreen({0.f, 0.f}), proj.toScreen({world_w, 0.f}),
+                       proj.toScreen({0.f, world_h}), proj.toScreen({world_w, world_h})};
+    float x0 = c[0].x, x1 = c[0].x, y0 = c[0].y, y1 = c[0].y;
+    for (const Vec2 &p : c)
+    {
+        x0 = std::min(x0, p.x);
+        x1 = std::max(x1, p.x);
+        y0 = std::min(y0, p.y);
+        y1 = std::max(y1, p.y);
+    }
+    return {x0, y0, x1 - x0, y1 - y0};
+}
+
+// 화면 사각형을 월드로 되돌려 덮는 월드 사각형 (컬링용)
+template <ScreenProjection P>
+AABB worldBounds(const P &proj, const AABB &screen)
+{
+    const Vec2 c[4] = {proj.toWorld({screen.x, screen.y}), proj.toWorld({screen.x + screen.w, screen.y}),
+                       proj.toWorld({screen.x, screen.y + screen.h}), proj.toWorld({screen.x + screen.w, screen.y + screen.h})};
+    float x0 = c[0].x, x1 = c[0].x, y0 = c[0].y, y1 = c[0].y;
+    for (const Vec2 &p : c)
+    {
+        x0 = std::min(x0, p.x);
+        x1 = std::max(x1, p.x);
+        y0 = std::min(y0, p.y);
+        y1 = std::max(y1, p.y);
+    }
+    return {x0, y0, x1 - x0, y1 - y0};
+}
+} // namespace folio::geometry
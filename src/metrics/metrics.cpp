@@ -0,0 +1,189 @@
+#include "metrics.hpp"
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+
+namespace folio::metrics
+{
+HistogramSummary Histogram::summarize(bool reset)
+{
+    HistogramSummary s{};
+    std::array<std::uint64_t, kBuckets> counts{};
+    std::uint64_t total = 0;
+    for (int i = 0; i < kBuckets; ++i)
+    {
+        counts[i] = reset ? buckets_[i].exchange(0, std::memory_order_relaxed)
+                          : buckets_[i].load(std::memory_order_relaxed);
+        total += counts[i];
+    }
+    if (reset)
+    {
+        s.sum = sum_.exchange(0, std::memory_order_relaxed);
+        s.max = max_.exchange(0, std::memory_order_relaxed);
+    }
+    else
+    {
+        s.sum = sum_.load(std::memory_order_relaxed);
+        s.max = max_.load(std::memory_order_relaxed);
+    }
+    // 개수와 백분위는 버킷 합으로
+    s.count = total;
+    if (total == 0)
+    {
+        return s;
+    }
+    const double ps[4] = {0.5, 0.9, 0.99, 0.999};
+    std::uint64_t *outs[4] = {&s.p50, &s.p90, &s.p99, &s.p999};
+    std::uint64_t seen = 0;
+    int k = 0;
+    for (int i = 0; i < kBuckets && k < 4; ++i)
+    {
+        seen += counts[i];
+        while (k < 4 && double(seen) >= ps[k] * double(total))
+        {
+            *outs[k] = std::min(value(i), s.max > 0 ? s.max : value(i));
+            ++k;
+        }
+    }
+    return s;
+}
+
+template <typename T>
+T &Registry::find(std::vector<Named<T>> &list, const std::string &name)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto &n : list)
+    {
+        if (n.name == name)
+        {
+            return *n.metric;
+        }
+    }
+    list.push_back(Named<T>{name, std::make_unique<T>()});
+    return *list.back().metric;
+}
+
+Counter &Registry::counter(const std::string &name) { return find(counters_, name); }
+Gauge &Registry::gauge(const std::string &name) { return find(gauges_, name); }
+Histogram &Registry::histogram(const std::string &name) { return find(histograms_, name); }
+
+Snapshot Registry::collect(double interval_sec, bool reset)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    Snapshot snap{};
+    snap.interval_sec = interval_sec;
+    for (auto &c : counters_)
+    {
+        Sample s{c.name, Sample::Kind::Counter};
+        s.count = reset ? c.metric->take() : c.metric->load();
+        s.rate = interval_sec > 0.0 ? double(s.count) / interval_sec : 0.0;
+        snap.samples.push_back(std::move(s));
+    }
+    for (auto &g : gauges_)
+    {
+        Sample s{g.name, Sample::Kind::Gauge};
+        s.value = g.metric->load();
+        s.max = reset ? g.metric->takeMax() : g.metric->max();
+        snap.samples.push_back(std::move(s));
+    }
+    for (auto &h : histograms_)
+    {
+        Sample s{h.name, Sample::Kind::Histogram};
+        s.hist = h.metric->summarize(reset);
+        snap.samples.push_back(std::move(s));
+    }
+    return snap;
+}
+
+Registry &registry()
+{
+    static Registry reg;
+    return reg;
+}
+
+std::string toText(const Snapshot &snap)
+{
+    std::string out;
+    char line[256];
+    std::snprintf(line, sizeof(line), "-- metrics (%.2f s)\n", snap.interval_sec);
+    out += line;
+    for (const auto &s : snap.samples)
+    {
+        switch (s.kind)
+        {
+        case Sample::Kind::Counter:
+            std::snprintf(line, sizeof(line), "%-28s %12" PRIu64 "  (%.1f/s)\n", s.name.c_str(), s.count, s.rate);
+            break;
+        case Sample::Kind::Gauge:
+            std::snprintf(line, sizeof(line), "%-28s %12" PRId64 "  (max %" PRId64 ")\n", s.name.c_str(), s.value, s.max);
+            break;
+        case Sample::Kind::Histogram:
+            std::snprintf(line, sizeof(line),
+                          "%-28s n=%" PRIu64 " p50=%" PRIu64 " p90=%" PRIu64 " p99=%" PRIu64 " p999=%" PRIu64 " max=%" PRIu64 "\n",
+                          s.name.c_str(), s.hist.count, s.hist.p50, s.hist.p90, s.hist.p99, s.hist.p999, s.hist.max);
+            break;
+        }
+        out += line;
+    }
+    return out;
+}
+
+std::string toJson(const Snapshot &snap)
+{
+    // 이름은 코드에서 정하는 식별자라 이스케이프하지 않음
+    std::string out;
+    char buf[320];
+    std::snprintf(buf, sizeof(buf), "{\"interval_sec\":%.3f", snap.interval_sec);
+    out += buf;
+    for (const auto &s : snap.samples)
+    {
+        switch (s.kind)
+        {
+        case Sample::Kind::Counter:
+            std::snprintf(buf, sizeof(buf), ",\"%s\":{\"count\":%" PRIu64 ",\"rate\":%.3f}", s.name.c_str(), s.count, s.rate);
+            break;
+        case Sample::Kind::Gauge:
+            std::snprintf(buf, sizeof(buf), ",\"%s\":{\"value\":%" PRId64 ",\"max\":%" PRId64 "}", s.name.c_str(), s.value, s.max);
+            break;
+        case Sample::Kind::Histogram:
+            std::snprintf(buf, sizeof(buf),
+                          ",\"%s\":{\"count\":%" PRIu64 ",\"sum\":%" PRIu64 ",\"p50\":%" PRIu64 ",\"p90\":%" PRIu64
+                          ",\"p99\":%" PRIu64 ",\"p999\":%" PRIu64 ",\"max\":%" PRIu64 "}",
+                          s.name.c_str(), s.hist.count, s.hist.sum, s.hist.p50, s.hist.p90, s.hist.p99, s.hist.p999, s.hist.max);
+            break;
+        }
+        out += buf;
+    }
+    out += "}\n";
+    return out;
+}
+
+bool PeriodicDump::tick(double dt)
+{
+    elapsed_ += dt;
+    if (elapsed_ < interval_)
+    {
+        return false;
+    }
+    return flush();
+}
+
+bool PeriodicDump::flush()
+{
+    const Snapshot snap = reg_.collect(elapsed_, true);
+    elapsed_ = 0.0;
+    if (path_ == "-")
+    {
+        std::fputs(toText(snap).c_str(), stderr);
+        return true;
+    }
+    std::FILE *f = std::fopen(path_.c_str(), "ab");
+    if (!f)
+    {
+        return false;
+    }
+    const std::string json = toJson(snap);
+    const bool ok = std::fwrite(json.data(), 1, json.size(), f) == json.size();
+    return std::fclose(f) == 0 && ok;
+}
+} // namespace folio::metrics
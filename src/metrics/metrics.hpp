@@ -0,0 +1,199 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace folio::metrics
+{
+// 모든 갱신은 relaxed atomic 하나~몇 개. 어느 스레드에서든 락 없이 호출 가능
+// 등록(이름 조회)만 락을 잡으므로 호출하는 쪽에서 참조를 static으로 들고 있을 것
+//   static auto &bakes = metrics::counter("chunks.bakes");
+//   bakes.add();
+
+class alignas(64) Counter
+{
+public:
+    void add(std::uint64_t n = 1) { v_.fetch_add(n, std::memory_order_relaxed); }
+    std::uint64_t load() const { return v_.load(std::memory_order_relaxed); }
+    std::uint64_t take() { return v_.exchange(0, std::memory_order_relaxed); }
+
+private:
+    std::atomic<std::uint64_t> v_{0};
+};
+
+// 현재 값 + 마지막 스냅샷 이후 최댓값
+class alignas(64) Gauge
+{
+public:
+    void set(std::int64_t v)
+    {
+        v_.store(v, std::memory_order_relaxed);
+        raiseMax(v);
+    }
+    void add(std::int64_t d) { raiseMax(v_.fetch_add(d, std::memory_order_relaxed) + d); }
+
+    std::int64_t load() const { return v_.load(std::memory_order_relaxed); }
+    std::int64_t max() const { return max_.load(std::memory_order_relaxed); }
+    std::int64_t takeMax() { return max_.exchange(load(), std::memory_order_relaxed); }
+
+private:
+    void raiseMax(std::int64_t v)
+    {
+        std::int64_t m = max_.load(std::memory_order_relaxed);
+        while (v > m && !max_.compare_exchange_weak(m, v, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    std::atomic<std::int64_t> v_{0};
+    std::atomic<std::int64_t> max_{0};
+};
+
+struct HistogramSummary
+{
+    std::uint64_t count{0};
+    std::uint64_t sum{0};
+    std::uint64_t max{0};
+    std::uint64_t p50{0}, p90{0}, p99{0}, p999{0};
+};
+
+// HDR 스타일 log-linear 버킷: 2의 거듭제곱 구간마다 16칸 (상대 오차 6% 이하)
+// 값은 정수 (us, ns, 개수 등 단위는 이름에 붙일 것)
+class Histogram
+{
+public:
+    static constexpr int kSubBits = 4;
+    static constexpr int kSub = 1 << kSubBits;
+    static constexpr int kBuckets = kSub + (64 - kSubBits) * kSub;
+
+    void record(std::uint64_t v)
+    {
+        buckets_[index(v)].fetch_add(1, std::memory_order_relaxed);
+        sum_.fetch_add(v, std::memory_order_relaxed);
+        std::uint64_t m = max_.load(std::memory_order_relaxed);
+        while (v > m && !max_.compare_exchange_weak(m, v, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    // 버킷별로 원자적이라 기록 중에 reset해도 값이 사라지거나 두 번 세지지는 않음
+    // (요약 값들 사이의 일관성은 보장하지 않음)
+    HistogramSummary summarize(bool reset);
+
+    static int index(std::uint64_t v)
+    {
+        if (v < std::uint64_t(kSub))
+        {
+            return int(v);
+        }
+        const int e = std::bit_width(v) - kSubBits - 1; // v >> e 는 [kSub, 2 * kSub)
+        return kSub + e * kSub + int((v >> e) - kSub);
+    }
+    // 버킷의 대표값 (구간 중앙)
+    static std::uint64_t value(int idx)
+    {
+        if (idx < kSub)
+        {
+            return std::uint64_t(idx);
+        }
+        const int e = (idx - kSub) / kSub;
+        const std::uint64_t lo = std::uint64_t(kSub + (idx - kSub) % kSub) << e;
+        return lo + ((std::uint64_t(1) << e) >> 1);
+    }
+
+private:
+    std::array<std::atomic<std::uint64_t>, kBuckets> buckets_{};
+    std::atomic<std::uint64_t> sum_{0};
+    std::atomic<std::uint64_t> max_{0};
+};
+
+struct Sample
+{
+    enum class Kind : std::uint8_t
+    {
+        Counter,
+        Gauge,
+        Histogram
+    };
+
+    std::string name;
+    Kind kind{Kind::Counter};
+    std::uint64_t count{0};     // Counter: 구간 동안 증가량
+    double rate{0.0};           // Counter: 초당
+    std::int64_t value{0};      // Gauge: 현재 값
+    std::int64_t max{0};        // Gauge: 구간 최댓값
+    HistogramSummary hist{};    // Histogram
+};
+
+struct Snapshot
+{
+    double interval_sec{0.0};
+    std::vector<Sample> samples;
+};
+
+class Registry
+{
+public:
+    // 같은 이름이면 같은 객체. 참조는 Registry가 살아 있는 동안 유효
+    Counter &counter(const std::string &name);
+    Gauge &gauge(const std::string &name);
+    Histogram &histogram(const std::string &name);
+
+    // 등록 순서대로. reset이면 Counter/Histogram과 Gauge 최댓값을 새 구간으로 넘김
+    Snapshot collect(double interval_sec, bool reset = true);
+
+private:
+    template <typename T>
+    struct Named
+    {
+        std::string name;
+        std::unique_ptr<T> metric;
+    };
+
+    template <typename T>
+    T &find(std::vector<Named<T>> &list, const std::string &name);
+
+private:
+    std::mutex mutex_;
+    std::vector<Named<Counter>> counters_;
+    std::vector<Named<Gauge>> gauges_;
+    std::vector<Named<Histogram>> histograms_;
+};
+
+// 프로세스 전역 레지스트리
+Registry &registry();
+inline Counter &counter(const std::string &name) { return registry().counter(name); }
+inline Gauge &gauge(const std::string &name) { return registry().gauge(name); }
+inline Histogram &histogram(const std::string &name) { return registry().histogram(name); }
+
+// 사람이 읽는 한 줄씩 / JSON 객체 한 줄 (JSON Lines로 이어 붙이기 좋게)
+std::string toText(const Snapshot &snap);
+std::string toJson(const Snapshot &snap);
+
+// interval마다 collect(reset)해서 sink에 씀. path가 "-"면 stderr에 텍스트, 아니면 파일 끝에 JSON 한 줄
+class PeriodicDump
+{
+public:
+    PeriodicDump(std::string path, double interval_sec = 5.0, Registry &reg = registry())
+        : path_(std::move(path)), interval_(interval_sec), reg_(reg)
+    {
+    }
+
+    // dt: 지난 호출 이후 경과 시간. 덤프했으면 true
+    bool tick(double dt);
+    bool flush();
+
+private:
+    std::string path_;
+    double interval_;
+    double elapsed_{0.0};
+    Registry &reg_;
+};
+} // namespace folio::metrics
@@ -0,0 +1,423 @@
+#pragma once
+
+#include "src/concurrency/job_system.hpp"
+#include "src/geometry/types.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <vector>
+
+namespace folio::movement
+{
+using geometry::Vec2;
+
+struct AvoidanceParams
+{
+    float neighbor_dist{96.f};   // 이웃으로 볼 최대 거리 (월드 단위). 격자 칸 크기이기도 함
+    float time_horizon{1.f};     // 다른 agent와 이 시간(초) 안에 부딪히지 않는 속도를 고름
+    float time_horizon_obst{0.4f}; // 벽 타일에 대해
+};
+
+// agent 하나의 입력. pref_vel은 가고 싶은 속도 (경로/배회에서), vel은 지난 tick의 실제 속도
+struct AvoidanceAgent
+{
+    Vec2 pos{};
+    Vec2 vel{};
+    Vec2 pref_vel{};
+    float radius{8.f};
+    float max_speed{60.f};
+};
+
+// ORCA(Optimal Reciprocal Collision Avoidance) 방식의 지역 회피
+// agent마다 가까운 이웃 kMaxNeighbors개와 주변 벽 타일에서 허용 속도 반평면을 만들고,
+// 그 교집합 안에서 pref_vel에 가장 가까운 속도를 선형 계획법으로 고름
+// 이웃은 매 solve마다 만드는 균일 격자에서 찾음. agent별 계산은 서로 독립이라 워커에 나눠도
+// 결과가 같음 (입력만 읽고 자기 출력만 씀)
+class CrowdAvoidance
+{
+public:
+    static constexpr int kMaxNeighbors = 10;
+    static constexpr int kMaxLines = kMaxNeighbors + 16; // 이웃 + 주변 벽 타일
+
+    explicit CrowdAvoidance(AvoidanceParams params = {}) : p_(params) {}
+
+    const AvoidanceParams &params() const { return p_; }
+
+    // agents 전체로 격자를 만들고 which의 agent에 대해서만 새 속도를 out[k]에 (which.size() == out.size())
+    // solid(tx, ty): 벽 타일인지. tile_size: 타일 한 변 (월드 단위)
+    template <typename Solid>
+    void solve(std::span<const AvoidanceAgent> agents, std::span<const std::uint32_t> which, std::span<Vec2> out,
+               float dt, Solid &&solid, int tile_size, concurrency::JobSystem *jobs = nullptr, int grain = 64)
+    {
+        buildGrid(agents);
+        const auto run = [&](int lo, int hi) {
+            for (int k = lo; k < hi; ++k)
+            {
+                out[size_t(k)] = solveOne(agents, which[size_t(k)], dt, solid, tile_size);
+            }
+        };
+        if (jobs)
+        {
+            jobs->parallelFor(0, int(which.size()), grain, run);
+        }
+        else
+        {
+            run(0, int(which.size()));
+        }
+    }
+
+private:
+    // 허용 속도 반평면: dir의 왼쪽이 허용 (RVO2와 같은 규약)
+    struct Line
+    {
+        Vec2 point{};
+        Vec2 dir{};
+    };
+
+    static float dot(const Vec2 &a, const Vec2 &b) { return a.x * b.x + a.y * b.y; }
+    static float det(const Vec2 &a, const Vec2 &b) { return a.x * b.y - a.y * b.x; }
+    static float lenSq(const Vec2 &a) { return dot(a, a); }
+
+    // ---- 이웃 격자 ----
+    void buildGrid(std::span<const AvoidanceAgent> agents)
+    {
+        const float cell = std::max(1.f, p_.neighbor_dist);
+        float x0 = std::numeric_limits<float>::max(), y0 = x0;
+        float x1 = std::numeric_limits<float>::lowest(), y1 = x1;
+        for (const auto &a : agents)
+        {
+            x0 = std::min(x0, a.pos.x);
+            y0 = std::min(y0, a.pos.y);
+            x1 = std::max(x1, a.pos.x);
+            y1 = std::max(y1, a.pos.y);
+        }
+        if (agents.empty())
+        {
+            x0 = y0 = x1 = y1 = 0.f;
+        }
+        origin_ = {x0, y0};
+        inv_cell_ = 1.f / cell;
+        cols_ = std::min(4096, int((x1 - x0) * inv_cell_) + 1);
+        rows_ = std::min(4096, int((y1 - y0) * inv_cell_) + 1);
+
+        // counting sort: cell_start_[c] .. cell_start_[c + 1]이 칸 c의 agent
+        cell_start_.assign(size_t(cols_) * rows_ + 1, 0);
+        agent_cell_.resize(agents.size());
+        for (size_t i = 0; i < agents.size(); ++i)
+        {
+            const int c = cellOf(agents[i].pos);
+            agent_cell_[i] = c;
+            ++cell_start_[size_t(c) + 1];
+        }
+        for (size_t c = 1; c < cell_start_.size(); ++c)
+        {
+            cell_start_[c] += cell_start_[c - 1];
+        }
+        sorted_.resize(agents.size());
+        fill_.assign(cell_start_.begin(), cell_start_.end() - 1);
+        for (size_t i = 0; i < agents.size(); ++i)
+        {
+            sorted_[size_t(fill_[size_t(agent_cell_[i])]++)] = std::uint32_t(i);
+        }
+    }
+
+    int cellOf(const Vec2 &p) const
+    {
+        const int cx = std::clamp(int((p.x - origin_.x) * inv_cell_), 0, cols_ - 1);
+        const int cy = std::clamp(int((p.y - origin_.y) * inv_cell_), 0, rows_ - 1);
+        return cy * cols_ + cx;
+    }
+
+    // 가까운 순 kMaxNeighbors개. 같은 거리면 번호 순이라 결과가 순회 순서와 무관
+    int neighbors(std::span<const AvoidanceAgent> agents, std::uint32_t self,
+                  std::array<std::uint32_t, kMaxNeighbors> &ids) const
+    {
+        std::array<float, kMaxNeighbors> d2{};
+        int n = 0;
+        const Vec2 p = agents[self].pos;
+        const float range2 = p_.neighbor_dist * p_.neighbor_dist;
+        const int c = agent_cell_[self];
+        const int cx = c % cols_, cy = c / cols_;
+        for (int y = std::max(0, cy - 1); y <= std::min(rows_ - 1, cy + 1); ++y)
+        {
+            for (int x = std::max(0, cx - 1); x <= std::min(cols_ - 1, cx + 1); ++x)
+            {
+                const int cell = y * cols_ + x;
+                for (int k = cell_start_[size_t(cell)]; k < cell_start_[size_t(cell) + 1]; ++k)
+                {
+                    const std::uint32_t j = sorted_[size_t(k)];
+                    if (j == self)
+                    {
+                        continue;
+                    }
+                    const float dd = lenSq(agents[j].pos - p);
+                    if (dd >= range2 || (n == kMaxNeighbors && (dd > d2[n - 1] || (dd == d2[n - 1] && j > ids[n - 1]))))
+                    {
+                        continue;
+                    }
+                    // 삽입 정렬
+                    int at = std::min(n, kMaxNeighbors - 1);
+                    while (at > 0 && (d2[at - 1] > dd || (d2[at - 1] == dd && ids[at - 1] > j)))
+                    {
+                        d2[at] = d2[at - 1];
+                        ids[at] = ids[at - 1];
+                        --at;
+                    }
+                    d2[at] = dd;
+                    ids[at] = j;
+                    n = std::min(n + 1, kMaxNeighbors);
+                }
+            }
+        }
+        return n;
+    }
+
+    // ---- agent 하나 ----
+    template <typename Solid>
+    Vec2 solveOne(std::span<const AvoidanceAgent> agents, std::uint32_t self, float dt, Solid &solid, int tile_size) const
+    {
+        const AvoidanceAgent &a = agents[self];
+        std::array<Line, kMaxLines> lines;
+        int count = 0;
+
+        // 벽 타일: 가장 가까운 점까지 time_horizon_obst 안에 닿지 않도록 (정적이라 반씩 나누지 않음)
+        const float inv_obst = 1.f / p_.time_horizon_obst;
+        const float reach = a.radius + a.max_speed * p_.time_horizon_obst;
+        const float ts = float(tile_size);
+        const int tx0 = int(std::floor((a.pos.x - reach) / ts)), tx1 = int(std::floor((a.pos.x + reach) / ts));
+        const int ty0 = int(std::floor((a.pos.y - reach) / ts)), ty1 = int(std::floor((a.pos.y + reach) / ts));
+        for (int ty = ty0; ty <= ty1 && count < kMaxLines - kMaxNeighbors; ++ty)
+        {
+            for (int tx = tx0; tx <= tx1 && count < kMaxLines - kMaxNeighbors; ++tx)
+            {
+                if (!solid(tx, ty))
+                {
+                    continue;
+                }
+                const Vec2 q{std::clamp(a.pos.x, tx * ts, (tx + 1) * ts), std::clamp(a.pos.y, ty * ts, (ty + 1) * ts)};
+                const Vec2 rel = q - a.pos;
+                const float dist = std::sqrt(lenSq(rel));
+                if (dist >= reach || dist < 1e-4f)
+                {
+                    continue;
+                }
+                // 벽 쪽 성분 <= (dist - r) / tau. 이미 겹쳤으면 밀어냄
+                const Vec2 n = rel * (1.f / dist);
+                const float limit = (dist - a.radius) * (dist > a.radius ? inv_obst : 1.f / dt);
+                lines[size_t(count++)] = Line{n * limit, Vec2{-n.y, n.x}};
+            }
+        }
+        const int obstacle_lines = count;
+
+        std::array<std::uint32_t, kMaxNeighbors> ids{};
+        const int n = neighbors(agents, self, ids);
+        const float inv_tau = 1.f / p_.time_horizon;
+        for (int k = 0; k < n; ++k)
+        {
+            const AvoidanceAgent &b = agents[ids[size_t(k)]];
+            const Vec2 rel_pos = b.pos - a.pos;
+            const Vec2 rel_vel = a.vel - b.vel;
+            const float dist_sq = lenSq(rel_pos);
+            const float r = a.radius + b.radius;
+            const float r_sq = r * r;
+
+            Line line;
+            Vec2 u;
+            if (dist_sq > r_sq)
+            {
+                // 아직 겹치지 않음: 속도 장애물(잘린 원뿔)의 가장 가까운 경계로
+                const Vec2 w = rel_vel - rel_pos * inv_tau;
+                const float w_len_sq = lenSq(w);
+                const float dot1 = dot(w, rel_pos);
+                if (dot1 < 0.f && dot1 * dot1 > r_sq * w_len_sq)
+                {
+                    const float w_len = std::sqrt(w_len_sq);
+                    const Vec2 unit_w = w * (1.f / w_len);
+                    line.dir = Vec2{unit_w.y, -unit_w.x};
+                    u = unit_w * (r * inv_tau - w_len);
+                }
+                else
+                {
+                    const float leg = std::sqrt(dist_sq - r_sq);
+                    if (det(rel_pos, w) > 0.f)
+                    {
+                        line.dir = Vec2{rel_pos.x * leg - rel_pos.y * r, rel_pos.x * r + rel_pos.y * leg} * (1.f / dist_sq);
+                    }
+                    else
+                    {
+                        line.dir = Vec2{rel_pos.x * leg + rel_pos.y * r, -rel_pos.x * r + rel_pos.y * leg} * (-1.f / dist_sq);
+                    }
+                    u = line.dir * dot(rel_vel, line.dir) - rel_vel;
+                }
+            }
+            else
+            {
+                // 이미 겹침: 이번 step 안에 떨어지도록
+                const float inv_dt = 1.f / dt;
+                const Vec2 w = rel_vel - rel_pos * inv_dt;
+                const float w_len = std::sqrt(lenSq(w));
+                const Vec2 unit_w = w_len > 1e-6f ? w * (1.f / w_len) : Vec2{1.f, 0.f};
+                line.dir = Vec2{unit_w.y, -unit_w.x};
+                u = unit_w * (r * inv_dt - w_len);
+            }
+            // 상대방도 반을 피한다고 가정 (reciprocal)
+            line.point = a.vel + u * 0.5f;
+            lines[size_t(count++)] = line;
+        }
+
+        Vec2 result{};
+        const std::span<const Line> ls(lines.data(), size_t(count));
+        const int failed = linearProgram2(ls, a.max_speed, a.pref_vel, false, result);
+        if (failed < count)
+        {
+            linearProgram3(ls, obstacle_lines, failed, a.max_speed, result);
+        }
+        return result;
+    }
+
+    // ---- 선형 계획법 (반지름 max_speed 원 안, 반평면 교집합) ----
+
+    // lines[i] 위에서 최적점. 실패하면 false
+    static bool linearProgram1(std::span<const Line> lines, int i, float radius, const Vec2 &opt, bool dir_opt, Vec2 &result)
+    {
+        const Line &li = lines[size_t(i)];
+        const float dp = dot(li.point, li.dir);
+        const float disc = dp * dp + radius * radius - lenSq(li.point);
+        if (disc < 0.f)
+        {
+            return false; // 원과 만나지 않음
+        }
+        const float sq = std::sqrt(disc);
+        float t_left = -dp - sq;
+        float t_right = -dp + sq;
+        for (int j = 0; j < i; ++j)
+        {
+            const Line &lj = lines[size_t(j)];
+            const float denom = det(li.dir, lj.dir);
+            const float numer = det(lj.dir, li.point - lj.point);
+            if (std::abs(denom) <= 1e-6f)
+            {
+                if (numer < 0.f)
+                {
+                    return false; // 평행하고 허용 영역 밖
+                }
+                continue;
+            }
+            const float t = numer / denom;
+            if (denom >= 0.f)
+            {
+                t_right = std::min(t_right, t);
+            }
+            else
+            {
+                t_left = std::max(t_left, t);
+            }
+            if (t_left > t_right)
+            {
+                return false;
+            }
+        }
+        float t;
+        if (dir_opt)
+        {
+            t = dot(opt, li.dir) > 0.f ? t_right : t_left;
+        }
+        else
+        {
+            t = std::clamp(dot(li.dir, opt - li.point), t_left, t_right);
+        }
+        result = li.point + li.dir * t;
+        return true;
+    }
+
+    // 실패한 line 번호를 돌려줌 (모두 만족하면 lines.size())
+    static int linearProgram2(std::span<const Line> lines, float radius, const Vec2 &opt, bool dir_opt, Vec2 &result)
+    {
+        if (dir_opt)
+        {
+            result = opt * radius; // opt는 단위 벡터
+        }
+        else if (lenSq(opt) > radius * radius)
+        {
+            result = geometry::norm(opt) * radius;
+        }
+        else
+        {
+            result = opt;
+        }
+        for (int i = 0; i < int(lines.size()); ++i)
+        {
+            if (det(lines[size_t(i)].dir, lines[size_t(i)].point - result) > 0.f)
+            {
+                const Vec2 prev = result;
+                if (!linearProgram1(lines, i, radius, opt, dir_opt, result))
+                {
+                    result = prev;
+                    return i;
+                }
+            }
+        }
+        return int(lines.size());
+    }
+
+    // 교집합이 비었을 때: 벽(앞쪽 fixed개)은 지키고 이웃 제약의 최대 위반량을 최소화
+    static void linearProgram3(std::span<const Line> lines, int fixed, int begin, float radius, Vec2 &result)
+    {
+        float distance = 0.f;
+        std::array<Line, kMaxLines> proj;
+        for (int i = begin; i < int(lines.size()); ++i)
+        {
+            const Line &li = lines[size_t(i)];
+            if (det(li.dir, li.point - result) <= distance)
+            {
+                continue;
+            }
+            int pn = 0;
+            for (int j = 0; j < fixed; ++j)
+            {
+                proj[size_t(pn++)] = lines[size_t(j)];
+            }
+            for (int j = fixed; j < i; ++j)
+            {
+                const Line &lj = lines[size_t(j)];
+                Line line;
+                const float d = det(li.dir, lj.dir);
+                if (std::abs(d) <= 1e-6f)
+                {
+                    if (dot(li.dir, lj.dir) > 0.f)
+                    {
+                        continue; // 같은 방향
+                    }
+                    line.point = (li.point + lj.point) * 0.5f;
+                }
+                else
+                {
+                    line.point = li.point + li.dir * (det(lj.dir, li.point - lj.point) / d);
+                }
+                line.dir = geometry::norm(lj.dir - li.dir);
+                proj[size_t(pn++)] = line;
+            }
+            const Vec2 prev = result;
+            const std::span<const Line> ps(proj.data(), size_t(pn));
+            if (linearProgram2(ps, radius, Vec2{-li.dir.y, li.dir.x}, true, result) < pn)
+            {
+                result = prev; // 수치 오차로만 생김
+            }
+            distance = det(li.dir, li.point - result);
+        }
+    }
+
+private:
+    AvoidanceParams p_{};
+    Vec2 origin_{};
+    float inv_cell_{1.f};
+    int cols_{1}, rows_{1};
+    std::vector<int> cell_start_;
+    std::vector<int> fill_;
+    std::vector<int> agent_cell_;
+    std::vector<std::uint32_t> sorted_;
+};
+} // namespace folio::movement
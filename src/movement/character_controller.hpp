@@ -2,6 +2,7 @@
 
 #include "src/core/time.hpp"
 #include "src/core/input.hpp"
+#include "src/geometry/projection.hpp"
 #include "src/geometry/types.hpp"
 
 namespace folio::movement
@@ -32,19 +33,29 @@ public:
         rt_.stamina = p_.stamina_max;
     }
 
+    // 화면 기준 입력(상하좌우)을 proj로 월드 방향으로 바꿔서 이동
+    // top-down이면 그대로, 아이소면 화면에서 같은 속도로 보이도록
+    template <geometry::ScreenProjection Projection>
     void tick(geometry::Transform &tr,
               const core::InputState &in,
+              const Projection &proj,
               const FixedDelta &dt,
-              const geometry::AABB &bounds);
+              const geometry::AABB &bounds)
+    {
+        const geometry::Vec2 screen_dir{(in.right ? 1.f : 0.f) - (in.left ? 1.f : 0.f),
+                                        (in.down ? 1.f : 0.f) - (in.up ? 1.f : 0.f)};
+        move(tr, in, proj.screenDirToWorld(geometry::norm(screen_dir)), dt, bounds);
+    }
 
-    // Isometric or custom control: supply world-space direction directly
-    void tickIso(geometry::Transform &tr,
-                 const core::InputState &in,
-                 const geometry::Vec2 &world_dir,
-                 const FixedDelta &dt,
-                 const geometry::AABB &bounds);
+    // Custom control (AI, scripted): supply world-space direction directly
+    void move(geometry::Transform &tr,
+              const core::InputState &in,
+              const geometry::Vec2 &world_dir,
+              const FixedDelta &dt,
+              const geometry::AABB &bounds);
 
     const MoveRuntime &runtime() const { return rt_; }
+    void setRuntime(const MoveRuntime &rt) { rt_ = rt; } // 스냅샷 복원용
 
 private:
     MoveParams p_;
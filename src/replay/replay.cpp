@@ -0,0 +1,171 @@
+#include "replay.hpp"
+#include <algorithm>
+
+namespace folio::replay
+{
+namespace
+{
+constexpr std::uint8_t kMagic[4] = {'F', 'O', 'L', 'R'};
+
+// tick 레코드 비트. 대부분의 tick은 varint 1~2바이트로 끝남
+constexpr std::uint32_t kUp = 1 << 0;
+constexpr std::uint32_t kDown = 1 << 1;
+constexpr std::uint32_t kLeft = 1 << 2;
+constexpr std::uint32_t kRight = 1 << 3;
+constexpr std::uint32_t kDash = 1 << 4;
+constexpr std::uint32_t kFacingRight = 1 << 5;
+constexpr std::uint32_t kPaint = 1 << 6;
+constexpr std::uint32_t kTravel = 1 << 7;
+constexpr std::uint32_t kTravelCommit = 1 << 8;
+constexpr std::uint32_t kDtChanged = 1 << 9;
+constexpr std::uint32_t kRestore = 1 << 10;
+} // namespace
+
+Recorder::Recorder(std::string path, std::uint32_t seed, bool with_hash)
+    : path_(std::move(path)), with_hash_(with_hash)
+{
+    for (std::uint8_t m : kMagic)
+    {
+        out_.put(m);
+    }
+    out_.put(kReplayVersion);
+    out_.put(seed);
+    out_.put(std::uint8_t(with_hash ? 1 : 0));
+}
+
+void Recorder::record(const TickInput &tick, std::uint32_t hash)
+{
+    std::uint32_t bits = 0;
+    bits |= tick.in.up ? kUp : 0;
+    bits |= tick.in.down ? kDown : 0;
+    bits |= tick.in.left ? kLeft : 0;
+    bits |= tick.in.right ? kRight : 0;
+    bits |= tick.in.dash ? kDash : 0;
+    bits |= tick.facing_right ? kFacingRight : 0;
+    bits |= tick.paint_value >= 0 ? kPaint : 0;
+    bits |= tick.travel ? kTravel : 0;
+    bits |= tick.travel_commit ? kTravelCommit : 0;
+    bits |= (ticks_ == 0 || tick.dt != last_dt_) ? kDtChanged : 0;
+    bits |= !tick.restore.empty() ? kRestore : 0;
+
+    out_.varint(bits);
+    if (bits & kDtChanged)
+    {
+        out_.put(tick.dt);
+        last_dt_ = tick.dt;
+    }
+    if (bits & kPaint)
+    {
+        out_.varint(std::uint32_t(tick.paint_x));
+        out_.varint(std::uint32_t(tick.paint_y));
+        out_.varint(std::uint32_t(tick.paint_value));
+    }
+    if (bits & kRestore)
+    {
+        out_.varint(tick.restore.size());
+        out_.append(tick.restore);
+    }
+    if (with_hash_)
+    {
+        out_.put(hash);
+    }
+    ++ticks_;
+}
+
+bool Recorder::close()
+{
+    if (closed_)
+    {
+        return true;
+    }
+    closed_ = true;
+    return save::writeFile(path_, out_.bytes());
+}
+
+bool Replayer::load(const std::string &path)
+{
+    std::vector<std::uint8_t> bytes;
+    if (!save::readFile(path, bytes))
+    {
+        return false;
+    }
+    save::ByteReader in(bytes.data(), bytes.size());
+    std::uint8_t magic[4]{};
+    std::uint32_t version = 0;
+    std::uint8_t with_hash = 0;
+    for (auto &m : magic)
+    {
+        in.get(m);
+    }
+    in.get(version);
+    in.get(seed_);
+    in.get(with_hash);
+    if (!in.ok() || !std::equal(magic, magic + 4, kMagic) || version != kReplayVersion)
+    {
+        return false;
+    }
+    with_hash_ = with_hash != 0;
+
+    ticks_.clear();
+    hashes_.clear();
+    cursor_ = 0;
+    float dt = 0.f;
+    while (!in.done())
+    {
+        std::uint64_t bits = 0;
+        if (!in.varint(bits) || ((bits & kDtChanged) && !in.get(dt)))
+        {
+            return false;
+        }
+        TickInput tick{};
+        tick.dt = dt;
+        tick.in.up = bits & kUp;
+        tick.in.down = bits & kDown;
+        tick.in.left = bits & kLeft;
+        tick.in.right = bits & kRight;
+        tick.in.dash = bits & kDash;
+        tick.facing_right = bits & kFacingRight;
+        tick.travel = bits & kTravel;
+        tick.travel_commit = bits & kTravelCommit;
+        if (bits & kPaint)
+        {
+            std::uint64_t x = 0, y = 0, v = 0;
+            if (!in.varint(x) || !in.varint(y) || !in.varint(v))
+            {
+                return false;
+            }
+            tick.paint_x = std::int32_t(x);
+            tick.paint_y = std::int32_t(y);
+            tick.paint_value = std::int32_t(v);
+        }
+        if (bits & kRestore)
+        {
+            std::uint64_t n = 0;
+            if (!in.varint(n) || !in.bytes(tick.restore, size_t(n)))
+            {
+                return false;
+            }
+        }
+        std::uint32_t hash = 0;
+        if (with_hash_ && !in.get(hash))
+        {
+            return false;
+        }
+        ticks_.push_back(tick);
+        hashes_.push_back(hash);
+    }
+    return true;
+}
+
+bool Replayer::next(TickInput &tick, std::uint32_t &expected_hash)
+{
+    if (done())
+    {
+        return false;
+    }
+    tick = ticks_[cursor_];
+    expected_hash = hashes_[cursor_];
+    ++cursor_;
+    return true;
+}
+} // namespace folio::replay
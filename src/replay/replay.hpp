@@ -0,0 +1,89 @@
+#pragma once
+
+#include "src/core/input.hpp"
+#include "src/save/snapshot.hpp"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace folio::replay
+{
+constexpr std::uint32_t kReplayVersion = 2;
+
+// fixed step 한 번에 시뮬레이션이 받는 입력 전부 (라이브 입력 장치와 무관)
+struct TickInput
+{
+    float dt{1.f / 120.f};
+    core::InputState in{};
+    bool facing_right{true};
+    std::int32_t paint_value{-1}; // -1 = 칠하지 않음
+    std::int32_t paint_x{0}, paint_y{0};
+    bool travel{false};        // 맵 전환 요청
+    bool travel_commit{false}; // 이 tick에 맵 전환이 확정됨 (백그라운드 준비 시점과 무관하게 재현하기 위함)
+    std::vector<std::uint8_t> restore{}; // 비어 있지 않으면 이 tick 시작에 복원할 스냅샷 (퀵로드도 기록에 남김)
+};
+
+// FNV-1a. 시뮬레이션 상태를 tick마다 요약해 재생 중 어긋나는 지점을 찾는 용도
+class StateHash
+{
+public:
+    void add(const void *data, size_t size)
+    {
+        const auto *p = static_cast<const std::uint8_t *>(data);
+        for (size_t i = 0; i < size; ++i)
+        {
+            h_ = (h_ ^ p[i]) * 16777619u;
+        }
+    }
+    template <typename T>
+    void add(const T &v) { add(&v, sizeof(T)); }
+
+    std::uint32_t value() const { return h_; }
+
+private:
+    std::uint32_t h_{2166136261u};
+};
+
+// tick 입력을 메모리에 쌓고 close() 때 파일로 씀
+class Recorder
+{
+public:
+    Recorder(std::string path, std::uint32_t seed, bool with_hash);
+    ~Recorder() { close(); }
+
+    void record(const TickInput &tick, std::uint32_t hash = 0);
+    bool close();
+
+    size_t ticks() const { return ticks_; }
+
+private:
+    std::string path_;
+    save::ByteWriter out_;
+    bool with_hash_;
+    bool closed_{false};
+    float last_dt_{0.f};
+    size_t ticks_{0};
+};
+
+class Replayer
+{
+public:
+    bool load(const std::string &path);
+
+    std::uint32_t seed() const { return seed_; }
+    bool hasHash() const { return with_hash_; }
+    size_t size() const { return ticks_.size(); }
+    bool done() const { return cursor_ >= ticks_.size(); }
+    size_t cursor() const { return cursor_; }
+
+    // 다음 tick 입력. expected_hash는 기록에 해시가 있을 때만 의미 있음
+    bool next(TickInput &tick, std::uint32_t &expected_hash);
+
+private:
+    std::uint32_t seed_{0};
+    bool with_hash_{false};
+    std::vector<TickInput> ticks_;
+    std::vector<std::uint32_t> hashes_;
+    size_t cursor_{0};
+};
+} // namespace folio::replay
@@ -0,0 +1,353 @@
+#include "snapshot.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+
+namespace folio::save
+{
+namespace
+{
+constexpr std::uint8_t kMagic[4] = {'F', 'O', 'L', 'S'};
+}
+
+MapDelta::MapDelta(const world::TileMap &base, int chunk_tiles)
+    : base_(base.tiles), w_(base.w), h_(base.h), chunk_(chunk_tiles),
+      cw_(std::max(1, (base.w + chunk_tiles - 1) / chunk_tiles)),
+      ch_(std::max(1, (base.h + chunk_tiles - 1) / chunk_tiles)),
+      flags_(size_t(cw_ * ch_), 0), encoded_(size_t(cw_ * ch_))
+{
+}
+
+void MapDelta::markTile(int tx, int ty)
+{
+    if (tx < 0 || ty < 0 || tx >= w_ || ty >= h_)
+    {
+        return;
+    }
+    flags_[(ty / chunk_) * cw_ + tx / chunk_] |= kDiffers | kModified;
+}
+
+void MapDelta::encodeChunk(int idx, const world::TileMap &map)
+{
+    const int x0 = (idx % cw_) * chunk_, y0 = (idx / cw_) * chunk_;
+    const int x1 = std::min(w_, x0 + chunk_), y1 = std::min(h_, y0 + chunk_);
+
+    ByteWriter diffs;
+    std::uint64_t count = 0;
+    int next = 0; // 직전 diff 다음 로컬 인덱스
+    for (int y = y0; y < y1; ++y)
+    {
+        for (int x = x0; x < x1; ++x)
+        {
+            const int t = y * w_ + x;
+            if (map.tiles[t] == base_[t])
+            {
+                continue;
+            }
+            const int local = (y - y0) * chunk_ + (x - x0);
+            diffs.varint(std::uint64_t(local - next));
+            diffs.varint(std::uint32_t(map.tiles[t]));
+            next = local + 1;
+            ++count;
+        }
+    }
+
+    auto &enc = encoded_[idx];
+    enc.clear();
+    if (count == 0)
+    {
+        flags_[idx] = 0; // 다시 베이스와 같아짐
+        return;
+    }
+    ByteWriter out;
+    out.varint(std::uint64_t(idx));
+    out.varint(count);
+    out.append(diffs.bytes());
+    enc = std::move(out.bytes());
+    flags_[idx] = kDiffers;
+}
+
+void MapDelta::write(ByteWriter &out, const world::TileMap &map)
+{
+    std::uint64_t chunks = 0;
+    for (int i = 0; i < cw_ * ch_; ++i)
+    {
+        if (flags_[i] & kModified)
+        {
+            encodeChunk(i, map);
+        }
+        chunks += (flags_[i] & kDiffers) ? 1 : 0;
+    }
+
+    out.varint(chunks);
+    for (int i = 0; i < cw_ * ch_; ++i)
+    {
+        if (flags_[i] & kDiffers)
+        {
+            out.append(encoded_[i]);
+        }
+    }
+}
+
+bool MapDelta::parse(ByteReader &in, Patch &patch) const
+{
+    std::uint64_t chunks = 0;
+    if (!in.varint(chunks) || chunks > std::uint64_t(cw_ * ch_))
+    {
+        return false;
+    }
+    for (std::uint64_t c = 0; c < chunks; ++c)
+    {
+        std::uint64_t idx = 0, count = 0;
+        if (!in.varint(idx) || idx >= std::uint64_t(cw_ * ch_) || !in.varint(count))
+        {
+            return false;
+        }
+        const int x0 = int(idx % cw_) * chunk_, y0 = int(idx / cw_) * chunk_;
+        patch.chunks.push_back(std::uint32_t(idx));
+
+        std::uint64_t local = 0;
+        for (std::uint64_t k = 0; k < count; ++k)
+        {
+            std::uint64_t gap = 0, value = 0;
+            if (!in.varint(gap) || !in.varint(value))
+            {
+                return false;
+            }
+            local += gap;
+            const int x = x0 + int(local % chunk_), y = y0 + int(local / chunk_);
+            if (local >= std::uint64_t(chunk_ * chunk_) || x >= w_ || y >= h_)
+            {
+                return false;
+            }
+            patch.tiles.emplace_back(std::uint32_t(y * w_ + x), int(value));
+            ++local;
+        }
+    }
+    return true;
+}
+
+void MapDelta::copyBase(int idx, world::TileMap &map) const
+{
+    const int x0 = (idx % cw_) * chunk_, y0 = (idx / cw_) * chunk_;
+    const int x1 = std::min(w_, x0 + chunk_), y1 = std::min(h_, y0 + chunk_);
+    for (int y = y0; y < y1; ++y)
+    {
+        std::copy(base_.begin() + (y * w_ + x0), base_.begin() + (y * w_ + x1), map.tiles.begin() + (y * w_ + x0));
+    }
+}
+
+void MapDelta::apply(const Patch &patch, world::TileMap &map, std::vector<std::pair<int, int>> &changed)
+{
+    std::vector<std::uint8_t> touched(flags_.size(), 0);
+
+    // 현재 베이스와 다른 청크만 되돌리면 됨
+    for (int i = 0; i < cw_ * ch_; ++i)
+    {
+        if (flags_[i] & kDiffers)
+        {
+            copyBase(i, map);
+            touched[i] = 1;
+        }
+        flags_[i] = 0;
+        encoded_[i].clear();
+    }
+    for (std::uint32_t idx : patch.chunks)
+    {
+        flags_[idx] = kDiffers | kModified;
+        touched[idx] = 1;
+    }
+    for (const auto &[t, v] : patch.tiles)
+    {
+        map.tiles[t] = v;
+    }
+
+    for (int i = 0; i < cw_ * ch_; ++i)
+    {
+        if (touched[i])
+        {
+            changed.emplace_back(i % cw_, i / cw_);
+        }
+    }
+}
+
+std::vector<std::uint8_t> writeSnapshot(const SimState &state, std::vector<MapRef> &maps)
+{
+    ByteWriter out;
+    for (std::uint8_t m : kMagic)
+    {
+        out.put(m);
+    }
+    out.put(kSnapshotVersion);
+    out.put(state.seed);
+    out.string(state.current_map);
+
+    out.put(state.player.pos.x);
+    out.put(state.player.pos.y);
+    out.put(state.player.r);
+    out.put(state.move.dash_remain);
+    out.put(state.move.stamina);
+    out.put(std::uint8_t(state.facing_right ? 1 : 0));
+    out.varint(state.actors.size());
+    out.append(state.actors);
+
+    out.varint(maps.size());
+    for (auto &ref : maps)
+    {
+        out.string(ref.map->id);
+        out.varint(std::uint32_t(ref.map->w));
+        out.varint(std::uint32_t(ref.map->h));
+        ref.delta->write(out, *ref.map);
+    }
+    return std::move(out.bytes());
+}
+
+namespace
+{
+bool readHeader(ByteReader &in)
+{
+    std::uint8_t magic[4]{};
+    std::uint32_t version = 0;
+    for (auto &m : magic)
+    {
+        in.get(m);
+    }
+    in.get(version);
+    return in.ok() && std::equal(magic, magic + 4, kMagic) && version == kSnapshotVersion;
+}
+} // namespace
+
+bool readSnapshotSeed(const std::vector<std::uint8_t> &bytes, std::uint32_t &seed)
+{
+    ByteReader in(bytes.data(), bytes.size());
+    return readHeader(in) && in.get(seed);
+}
+
+bool readSnapshot(const std::vector<std::uint8_t> &bytes, SimState &state, std::vector<MapRef> &maps,
+                  const ActorCheck &check)
+{
+    ByteReader in(bytes.data(), bytes.size());
+    if (!readHeader(in))
+    {
+        return false;
+    }
+
+    SimState next{};
+    std::uint8_t facing = 0;
+    in.get(next.seed);
+    in.string(next.current_map);
+    in.get(next.player.pos.x);
+    in.get(next.player.pos.y);
+    in.get(next.player.r);
+    in.get(next.move.dash_remain);
+    in.get(next.move.stamina);
+    in.get(facing);
+    next.facing_right = facing != 0;
+    std::uint64_t actors = 0;
+    if (in.varint(actors))
+    {
+        in.bytes(next.actors, size_t(actors));
+    }
+    if (!in.ok() || next.seed != state.seed)
+    {
+        return false;
+    }
+
+    // 전부 파싱/검증한 뒤에만 적용
+    std::uint64_t count = 0;
+    if (!in.varint(count) || count != maps.size())
+    {
+        return false;
+    }
+    std::vector<MapDelta::Patch> patches(maps.size());
+    for (size_t i = 0; i < maps.size(); ++i)
+    {
+        std::string id;
+        std::uint64_t w = 0, h = 0;
+        if (!in.string(id) || !in.varint(w) || !in.varint(h))
+        {
+            return false;
+        }
+        if (id != maps[i].map->id || int(w) != maps[i].map->w || int(h) != maps[i].map->h)
+        {
+            return false;
+        }
+        if (!maps[i].delta->parse(in, patches[i]))
+        {
+            return false;
+        }
+    }
+    if (!in.ok() || !in.done() || (check && !check(next.actors)))
+    {
+        return false;
+    }
+
+    for (size_t i = 0; i < maps.size(); ++i)
+    {
+        maps[i].changed.clear();
+        maps[i].delta->apply(patches[i], *maps[i].map, maps[i].changed);
+    }
+    state = std::move(next);
+    return true;
+}
+
+bool writeFile(const std::string &path, const std::vector<std::uint8_t> &bytes)
+{
+    // 쓰는 도중 죽어도 이전 파일이 남도록 임시 파일에 쓴 뒤 교체
+    const std::string tmp = path + ".tmp";
+    {
+        std::ofstream f(tmp, std::ios::binary | std::ios::trunc);
+        if (!f)
+        {
+            return false;
+        }
+        f.write(reinterpret_cast<const char *>(bytes.data()), std::streamsize(bytes.size()));
+        if (!f)
+        {
+            return false;
+        }
+    }
+    return std::rename(tmp.c_str(), path.c_str()) == 0;
+}
+
+bool readFile(const std::string &path, std::vector<std::uint8_t> &bytes)
+{
+    std::ifstream f(path, std::ios::binary | std::ios::ate);
+    if (!f)
+    {
+        return false;
+    }
+    const auto size = f.tellg();
+    f.seekg(0);
+    bytes.resize(size_t(size));
+    f.read(reinterpret_cast<char *>(bytes.data()), size);
+    return bool(f);
+}
+
+std::string userDataPath(const std::string &file)
+{
+    namespace fs = std::filesystem;
+    fs::path dir;
+    if (const char *xdg = std::getenv("XDG_DATA_HOME"); xdg && *xdg)
+    {
+        dir = xdg;
+    }
+    else if (const char *home = std::getenv("HOME"); home && *home)
+    {
+        dir = fs::path(home) / ".local" / "share";
+    }
+    else if (const char *app = std::getenv("APPDATA"); app && *app)
+    {
+        dir = app;
+    }
+    std::error_code ec;
+    if (dir.empty() || (!fs::create_directories(dir / "folio", ec) && ec))
+    {
+        dir = fs::temp_directory_path(ec);
+        return (dir / ("folio_" + file)).string();
+    }
+    return (dir / "folio" / file).string();
+}
+} // namespace folio::save
@@ -0,0 +1,190 @@
+#pragma once
+
+#include "src/geometry/types.hpp"
+#include "src/movement/character_controller.hpp"
+#include "src/world/tile_map.hpp"
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace folio::save
+{
+// 레이아웃이 바뀌면 올림. 다른 버전의 스냅샷은 읽지 않음
+constexpr std::uint32_t kSnapshotVersion = 2;
+
+class ByteWriter
+{
+public:
+    template <typename T>
+    void put(const T &v) // POD, 호스트 바이트 순서(little-endian 가정)
+    {
+        const auto *p = reinterpret_cast<const std::uint8_t *>(&v);
+        bytes_.insert(bytes_.end(), p, p + sizeof(T));
+    }
+    void varint(std::uint64_t v)
+    {
+        while (v >= 0x80)
+        {
+            bytes_.push_back(std::uint8_t(v) | 0x80);
+            v >>= 7;
+        }
+        bytes_.push_back(std::uint8_t(v));
+    }
+    void string(const std::string &s)
+    {
+        varint(s.size());
+        bytes_.insert(bytes_.end(), s.begin(), s.end());
+    }
+    void append(const std::vector<std::uint8_t> &raw) { bytes_.insert(bytes_.end(), raw.begin(), raw.end()); }
+
+    std::vector<std::uint8_t> &bytes() { return bytes_; }
+
+private:
+    std::vector<std::uint8_t> bytes_;
+};
+
+// 범위를 벗어나면 ok()가 false가 되고 이후 읽기는 모두 실패
+class ByteReader
+{
+public:
+    ByteReader(const std::uint8_t *data, size_t size) : data_(data), size_(size) {}
+
+    template <typename T>
+    bool get(T &v)
+    {
+        if (!ok_ || size_ - pos_ < sizeof(T))
+        {
+            return ok_ = false;
+        }
+        std::memcpy(&v, data_ + pos_, sizeof(T));
+        pos_ += sizeof(T);
+        return true;
+    }
+    bool varint(std::uint64_t &v)
+    {
+        v = 0;
+        for (int shift = 0; shift < 64; shift += 7)
+        {
+            std::uint8_t b = 0;
+            if (!get(b))
+            {
+                return false;
+            }
+            v |= std::uint64_t(b & 0x7f) << shift;
+            if ((b & 0x80) == 0)
+            {
+                return true;
+            }
+        }
+        return ok_ = false;
+    }
+    bool string(std::string &s)
+    {
+        std::uint64_t n = 0;
+        if (!varint(n) || size_ - pos_ < n)
+        {
+            return ok_ = false;
+        }
+        s.assign(reinterpret_cast<const char *>(data_ + pos_), size_t(n));
+        pos_ += size_t(n);
+        return true;
+    }
+    bool bytes(std::vector<std::uint8_t> &raw, size_t n)
+    {
+        if (!ok_ || size_ - pos_ < n)
+        {
+            return ok_ = false;
+        }
+        raw.assign(data_ + pos_, data_ + pos_ + n);
+        pos_ += n;
+        return true;
+    }
+
+    bool ok() const { return ok_; }
+    bool done() const { return pos_ == size_; }
+    size_t remaining() const { return size_ - pos_; }
+
+private:
+    const std::uint8_t *data_;
+    size_t size_;
+    size_t pos_{0};
+    bool ok_{true};
+};
+
+// 베이스(생성 직후) 맵 대비 타일 델타. 청크 단위 dirty 플래그로
+// 베이스와 같은 청크는 건너뛰고, 지난 스냅샷 이후 안 바뀐 청크는 이전 인코딩을 재사용
+class MapDelta
+{
+public:
+    MapDelta(const world::TileMap &base, int chunk_tiles = 32);
+
+    // 타일을 쓸 때마다 호출
+    void markTile(int tx, int ty);
+
+    struct Patch
+    {
+        std::vector<std::uint32_t> chunks;                // 베이스와 다른 청크
+        std::vector<std::pair<std::uint32_t, int>> tiles; // (타일 인덱스, 값)
+    };
+
+    void write(ByteWriter &out, const world::TileMap &map);
+    bool parse(ByteReader &in, Patch &patch) const;
+    // 베이스로 되돌린 뒤 patch를 적용. changed: 타일이 바뀐 청크 좌표
+    void apply(const Patch &patch, world::TileMap &map, std::vector<std::pair<int, int>> &changed);
+
+    int chunkTiles() const { return chunk_; }
+
+private:
+    enum : std::uint8_t
+    {
+        kDiffers = 1 << 0,  // 베이스와 다를 수 있음
+        kModified = 1 << 1, // 마지막 인코딩 이후 쓰기가 있었음
+    };
+
+    void encodeChunk(int idx, const world::TileMap &map);
+    void copyBase(int idx, world::TileMap &map) const;
+
+private:
+    std::vector<int> base_;
+    int w_, h_, chunk_, cw_, ch_;
+    std::vector<std::uint8_t> flags_;
+    std::vector<std::vector<std::uint8_t>> encoded_; // 청크별 델타 인코딩 캐시 (비어 있으면 베이스와 동일)
+};
+
+struct MapRef
+{
+    world::TileMap *map{nullptr};
+    MapDelta *delta{nullptr};
+    std::vector<std::pair<int, int>> changed{}; // readSnapshot이 채움
+};
+
+struct SimState
+{
+    std::uint32_t seed{0};
+    std::string current_map{};
+    geometry::Transform player{};
+    movement::MoveRuntime move{};
+    bool facing_right{true};
+    std::vector<std::uint8_t> actors{}; // 게임이 인코딩한 액터 상태 (NPC 등). 스냅샷은 그대로 싣기만 함
+};
+
+// readSnapshot이 맵을 바꾸기 직전에 actors를 넘겨 검사함. false면 스냅샷 전체를 거부
+using ActorCheck = std::function<bool(const std::vector<std::uint8_t> &actors)>;
+
+std::vector<std::uint8_t> writeSnapshot(const SimState &state, std::vector<MapRef> &maps);
+// 실패하면 false. 맵 이름/크기가 맞지 않거나 seed가 다르거나 check가 거부하면 아무것도 바꾸지 않음
+bool readSnapshot(const std::vector<std::uint8_t> &bytes, SimState &state, std::vector<MapRef> &maps,
+                  const ActorCheck &check = {});
+// 헤더의 seed만 읽음. 베이스 맵이 seed로 만들어지므로 이전 세션의 스냅샷을 읽으려면 같은 seed로 시작해야 함
+bool readSnapshotSeed(const std::vector<std::uint8_t> &bytes, std::uint32_t &seed);
+
+bool writeFile(const std::string &path, const std::vector<std::uint8_t> &bytes);
+bool readFile(const std::string &path, std::vector<std::uint8_t> &bytes);
+
+// 사용자 데이터 디렉터리 아래 folio/<file> 경로 (XDG_DATA_HOME, ~/.local/share, APPDATA 순, 없으면 임시 디렉터리)
+// 디렉터리는 없으면 만듦
+std::string userDataPath(const std::string &file);
+} // namespace folio::save
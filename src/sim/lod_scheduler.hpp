@@ -0,0 +1,316 @@
+#pragma once
+
+#include "src/geometry/types.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace folio::sim
+{
+using ActorId = std::uint32_t;
+
+enum class SimTier : std::uint8_t
+{
+    Full,    // 매 tick
+    Reduced, // period tick에 한 번
+    Dormant  // 멈춤. 다시 가까워지면 밀린 시간을 따라잡음
+};
+
+struct SimLodPolicy
+{
+    float full_radius{900.f};     // focus로부터 월드 거리
+    float reduced_radius{2400.f};
+    float hysteresis{0.1f};       // 반경의 비율. 경계에서 tier가 매 tick 바뀌지 않도록
+    int period{4};                // Reduced는 period tick마다 (actor마다 위상을 나눠서 tick당 1/period씩)
+    int dormant_scan_period{16};  // Dormant는 이 tick 수에 걸쳐 한 바퀴 거리 검사
+    float max_step{1.f / 30.f};   // 한 번의 step에 넘기는 최대 dt. 밀린 시간은 이 단위로 잘라서 넘김
+    float max_catchup{1.f};       // 한 번에 따라잡는 최대 시간. 넘는 부분은 버림
+};
+
+// collect()가 돌려주는 step 하나
+struct SimStep
+{
+    ActorId id{0};
+    float dt{0.f};
+};
+
+struct SimLodStats
+{
+    size_t full{0}, reduced{0}, dormant{0}; // tier별 actor 수
+    size_t ran{0};                          // 이번 tick에 갱신된 actor 수
+    size_t steps{0};                        // step 호출 수 (따라잡기 포함)
+    size_t scanned{0};                      // 거리 검사한 Dormant actor 수
+    float dropped{0.f};                     // max_catchup을 넘어 버린 시간 합
+};
+
+// actor를 focus(카메라/플레이어)와의 거리로 tier에 나누고, 이번 tick에 돌 actor만 step을 호출
+// actor마다 마지막으로 갱신된 시각을 들고 있어서 건너뛴 시간은 다음 step의 dt로 넘어감
+// tick 비용은 Full 수 + Reduced/period + Dormant/dormant_scan_period (Dormant는 거리 검사만)
+class SimLodScheduler
+{
+public:
+    explicit SimLodScheduler(SimLodPolicy policy = {}) : policy_(policy)
+    {
+        policy_.period = std::max(1, policy_.period);
+        policy_.dormant_scan_period = std::max(1, policy_.dormant_scan_period);
+        buckets_.resize(size_t(policy_.period) + 2);
+    }
+
+    ActorId add(SimTier tier = SimTier::Full)
+    {
+        ActorId id;
+        if (!free_.empty())
+        {
+            id = free_.back();
+            free_.pop_back();
+        }
+        else
+        {
+            id = ActorId(slots_.size());
+            slots_.push_back(Slot{});
+        }
+        slots_[id].last_time = time_;
+        place(id, tier);
+        return id;
+    }
+
+    void remove(ActorId id)
+    {
+        unlink(id);
+        slots_[id].bucket = kNoBucket;
+        free_.push_back(id);
+    }
+
+    SimTier tier(ActorId id) const { return tierOf(slots_[id].bucket); }
+    const SimLodStats &stats() const { return stats_; }
+    double time() const { return time_; }
+
+    // pos(id) -> Vec2, step(id, dt). step은 actor 하나에 대해 여러 번 불릴 수 있음 (따라잡기)
+    template <typename PosFn, typename StepFn>
+    void tick(float dt, const geometry::Vec2 &focus, PosFn &&pos, StepFn &&step)
+    {
+        advance(dt);
+        stats_.ran = stats_.steps = stats_.scanned = 0;
+        stats_.dropped = 0.f;
+
+        // 돌 actor: Full 전부 + 이번 위상의 Reduced
+        run(kFullBucket, focus, pos, step);
+        run(reducedBucket(tick_), focus, pos, step);
+
+        // Dormant는 일부만 거리 검사해서 가까워졌으면 올림 (따라잡기는 다음 run에서)
+        auto &dormant = buckets_[dormantBucket()];
+        const size_t slice = (dormant.size() + policy_.dormant_scan_period - 1) / policy_.dormant_scan_period;
+        for (size_t k = 0; k < slice && !dormant.empty(); ++k)
+        {
+            scan_cursor_ = scan_cursor_ < dormant.size() ? scan_cursor_ : 0;
+            const ActorId id = dormant[scan_cursor_];
+            ++stats_.scanned;
+            const SimTier t = classify(pos(id), focus, SimTier::Dormant);
+            if (t != SimTier::Dormant)
+            {
+                place(id, t); // swap-remove로 cursor 자리에 다른 actor가 들어옴
+            }
+            else
+            {
+                ++scan_cursor_;
+            }
+        }
+
+        stats_.full = buckets_[kFullBucket].size();
+        stats_.dormant = buckets_[dormantBucket()].size();
+        stats_.reduced = 0;
+        for (int p = 0; p < policy_.period; ++p)
+        {
+            stats_.reduced += buckets_[reducedBucket(p)].size();
+        }
+    }
+
+    // tick과 같지만 step을 바로 부르지 않고 out 끝에 모음 (actor 하나의 따라잡기 step은 연속으로 들어감)
+    // 그래서 병렬로 나눠 돌릴 수 있음. tier 재분류는 step 전 위치 기준이라 한 tick 늦음
+    template <typename PosFn>
+    void collect(float dt, const geometry::Vec2 &focus, PosFn &&pos, std::vector<SimStep> &out)
+    {
+        tick(dt, focus, pos, [&out](ActorId id, float h) { out.push_back(SimStep{id, h}); });
+    }
+
+    // actor를 돌리지 않고 시간만 진행 (focus가 없는 맵에 있을 때 등). 밀린 시간은 나중에 따라잡음
+    void advance(float dt)
+    {
+        time_ += dt;
+        ++tick_;
+    }
+
+    // 스냅샷용 전체 상태. 버킷 안의 순서가 step 순서이므로 그대로 되돌려야 이어서 돌린 결과가 같음
+    struct State
+    {
+        std::vector<double> last_time;              // actor별
+        std::vector<std::vector<ActorId>> buckets;  // 버킷별 actor 순서 (어느 버킷에도 없으면 제거된 actor)
+        std::vector<ActorId> free;
+        double time{0.0};
+        std::uint64_t tick{0};
+        std::uint64_t scan_cursor{0};
+    };
+
+    State state() const
+    {
+        State st;
+        st.last_time.reserve(slots_.size());
+        for (const Slot &s : slots_)
+        {
+            st.last_time.push_back(s.last_time);
+        }
+        st.buckets = buckets_;
+        st.free = free_;
+        st.time = time_;
+        st.tick = tick_;
+        st.scan_cursor = scan_cursor_;
+        return st;
+    }
+
+    // 같은 policy의 스케줄러가 만든 상태만 받음. 맞지 않으면 false (바뀌지 않음)
+    bool setState(const State &st)
+    {
+        if (st.buckets.size() != buckets_.size())
+        {
+            return false;
+        }
+        std::vector<Slot> slots(st.last_time.size());
+        for (std::uint32_t b = 0; b < st.buckets.size(); ++b)
+        {
+            for (std::uint32_t i = 0; i < st.buckets[b].size(); ++i)
+            {
+                const ActorId id = st.buckets[b][i];
+                if (id >= slots.size() || slots[id].bucket != kNoBucket)
+                {
+                    return false;
+                }
+                slots[id].bucket = b;
+                slots[id].index = i;
+            }
+        }
+        for (const ActorId id : st.free)
+        {
+            if (id >= slots.size() || slots[id].bucket != kNoBucket)
+            {
+                return false;
+            }
+        }
+        for (size_t id = 0; id < slots.size(); ++id)
+        {
+            slots[id].last_time = st.last_time[id];
+        }
+        slots_ = std::move(slots);
+        buckets_ = st.buckets;
+        free_ = st.free;
+        time_ = st.time;
+        tick_ = st.tick;
+        scan_cursor_ = size_t(st.scan_cursor);
+        return true;
+    }
+
+private:
+    static constexpr std::uint32_t kNoBucket = ~std::uint32_t(0);
+    static constexpr std::uint32_t kFullBucket = 0;
+
+    struct Slot
+    {
+        std::uint32_t bucket{kNoBucket};
+        std::uint32_t index{0}; // bucket 안의 위치
+        double last_time{0.0};  // 마지막으로 step이 끝난 시각
+    };
+
+    std::uint32_t reducedBucket(std::uint64_t phase) const { return 1 + std::uint32_t(phase % std::uint64_t(policy_.period)); }
+    std::uint32_t dormantBucket() const { return std::uint32_t(policy_.period) + 1; }
+    SimTier tierOf(std::uint32_t bucket) const
+    {
+        return bucket == kFullBucket ? SimTier::Full : (bucket == dormantBucket() ? SimTier::Dormant : SimTier::Reduced);
+    }
+
+    SimTier classify(const geometry::Vec2 &p, const geometry::Vec2 &focus, SimTier cur) const
+    {
+        const float dx = p.x - focus.x, dy = p.y - focus.y;
+        const float d2 = dx * dx + dy * dy;
+        // 지금 tier를 유지하는 쪽으로 경계를 넓힘
+        const float lo = 1.f - policy_.hysteresis, hi = 1.f + policy_.hysteresis;
+        const float full = policy_.full_radius * (cur == SimTier::Full ? hi : lo);
+        const float reduced = policy_.reduced_radius * (cur == SimTier::Dormant ? lo : hi);
+        if (d2 <= full * full)
+        {
+            return SimTier::Full;
+        }
+        return d2 <= reduced * reduced ? SimTier::Reduced : SimTier::Dormant;
+    }
+
+    void unlink(ActorId id)
+    {
+        Slot &s = slots_[id];
+        if (s.bucket == kNoBucket)
+        {
+            return;
+        }
+        auto &b = buckets_[s.bucket];
+        const ActorId last = b.back();
+        b[s.index] = last;
+        slots_[last].index = s.index;
+        b.pop_back();
+    }
+
+    void place(ActorId id, SimTier tier)
+    {
+        unlink(id);
+        Slot &s = slots_[id];
+        // Reduced는 id로 위상을 정해서 tick마다 고르게 나뉨
+        s.bucket = tier == SimTier::Full ? kFullBucket : (tier == SimTier::Dormant ? dormantBucket() : reducedBucket(id));
+        s.index = std::uint32_t(buckets_[s.bucket].size());
+        buckets_[s.bucket].push_back(id);
+    }
+
+    template <typename PosFn, typename StepFn>
+    void run(std::uint32_t bucket, const geometry::Vec2 &focus, PosFn &pos, StepFn &step)
+    {
+        const SimTier cur = tierOf(bucket);
+        moves_.clear();
+        for (const ActorId id : buckets_[bucket])
+        {
+            Slot &s = slots_[id];
+            float owed = float(time_ - s.last_time);
+            if (owed > policy_.max_catchup)
+            {
+                stats_.dropped += owed - policy_.max_catchup;
+                owed = policy_.max_catchup;
+            }
+            while (owed > 0.f)
+            {
+                const float h = std::min(owed, policy_.max_step);
+                step(id, h);
+                owed -= h;
+                ++stats_.steps;
+            }
+            s.last_time = time_;
+            ++stats_.ran;
+
+            const SimTier t = classify(pos(id), focus, cur);
+            if (t != cur)
+            {
+                moves_.push_back({id, t});
+            }
+        }
+        for (const auto &[id, t] : moves_)
+        {
+            place(id, t);
+        }
+    }
+
+private:
+    SimLodPolicy policy_{};
+    std::vector<Slot> slots_;
+    std::vector<ActorId> free_;
+    std::vector<std::vector<ActorId>> buckets_; // [0] Full, [1..period] Reduced 위상별, [period + 1] Dormant
+    std::vector<std::pair<ActorId, SimTier>> moves_;
+    double time_{0.0};
+    std::uint64_t tick_{0};
+    size_t scan_cursor_{0};
+    SimLodStats stats_{};
+};
+} // namespace folio::sim
@@ -0,0 +1,124 @@
+#pragma once
+
+#include "src/concurrency/job_system.hpp"
+#include "src/geometry/types.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace folio::sim
+{
+// 월드를 region_size 정사각형 region으로 나눈 격자. 범위 밖 좌표는 가장자리 region
+struct RegionLayout
+{
+    float region_size{512.f};
+    int cols{1}, rows{1};
+
+    static RegionLayout cover(float world_w, float world_h, float region_size)
+    {
+        RegionLayout l{};
+        l.region_size = region_size;
+        l.cols = std::max(1, int(std::ceil(world_w / region_size)));
+        l.rows = std::max(1, int(std::ceil(world_h / region_size)));
+        return l;
+    }
+
+    int count() const { return cols * rows; }
+    int at(const geometry::Vec2 &p) const
+    {
+        const int rx = std::clamp(int(std::floor(p.x / region_size)), 0, cols - 1);
+        const int ry = std::clamp(int(std::floor(p.y / region_size)), 0, rows - 1);
+        return ry * cols + rx;
+    }
+};
+
+// region 단위 병렬 갱신. region을 2x2 체커보드 4단계로 나눠서 한 단계 안의 region끼리는
+// 8방향으로도 이웃하지 않음. 그래서 region 하나를 도는 동안
+//   - 자기 항목(actor)의 상태는 직접 씀
+//   - 자기와 이웃 region이 가진 상태는 읽어도 됨 (같은 단계에서 쓰는 쪽이 없음)
+//   - 그 밖의 것(경계를 넘는 이동, 다른 actor/공유 상태에 주는 영향)은 outbox에 Effect로 남김
+// outbox는 모든 단계가 끝난 뒤 region 번호 순, region 안에서는 넣은 순으로 merge되므로
+// 결과는 워커 수와 무관하게 같음
+//
+// 매 tick: clear() -> push(region, item)... -> run(jobs, step) -> merge(apply)
+template <typename Effect>
+class RegionSim
+{
+public:
+    explicit RegionSim(RegionLayout layout = {}) { reset(layout); }
+
+    void reset(RegionLayout layout)
+    {
+        layout_ = layout;
+        items_.assign(size_t(layout_.count()), {});
+        outboxes_.assign(size_t(layout_.count()), {});
+    }
+
+    const RegionLayout &layout() const { return layout_; }
+
+    void clear()
+    {
+        for (auto &v : items_)
+        {
+            v.clear();
+        }
+        for (auto &v : outboxes_)
+        {
+            v.clear();
+        }
+    }
+
+    // 이번 tick에 region이 돌 항목 (호출하는 쪽의 인덱스). region 안에서는 push 순서대로 돎
+    void push(int region, std::uint32_t item) { items_[size_t(region)].push_back(item); }
+
+    // step(region, std::span<const std::uint32_t> items, std::vector<Effect> &outbox)
+    template <typename StepFn>
+    void run(concurrency::JobSystem &jobs, StepFn &&step)
+    {
+        for (int phase = 0; phase < 4; ++phase)
+        {
+            active_.clear();
+            for (int ry = phase >> 1; ry < layout_.rows; ry += 2)
+            {
+                for (int rx = phase & 1; rx < layout_.cols; rx += 2)
+                {
+                    const int r = ry * layout_.cols + rx;
+                    if (!items_[size_t(r)].empty())
+                    {
+                        active_.push_back(r);
+                    }
+                }
+            }
+            jobs.parallelFor(0, int(active_.size()), 1, [&](int lo, int hi) {
+                for (int k = lo; k < hi; ++k)
+                {
+                    const int r = active_[size_t(k)];
+                    step(r, std::span<const std::uint32_t>(items_[size_t(r)]), outboxes_[size_t(r)]);
+                }
+            });
+        }
+    }
+
+    // apply(const Effect &). 메인(호출한) 스레드에서 고정 순서로
+    template <typename ApplyFn>
+    void merge(ApplyFn &&apply)
+    {
+        for (auto &box : outboxes_)
+        {
+            for (const Effect &e : box)
+            {
+                apply(e);
+            }
+            box.clear();
+        }
+    }
+
+private:
+    RegionLayout layout_{};
+    std::vector<std::vector<std::uint32_t>> items_;
+    std::vector<std::vector<Effect>> outboxes_;
+    std::vector<int> active_; // 이번 단계에 돌 region
+};
+} // namespace folio::sim
@@ -0,0 +1,239 @@
+#pragma once
+
+#include "src/geometry/projection.hpp"
+#include "tile_map.hpp"
+#include <SFML/Graphics/Color.hpp>
+#include <SFML/Graphics/Vertex.hpp>
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define FOLIO_BAKE_SSE2 1
+#endif
+
+namespace folio::world
+{
+// 청크 하나의 정점 버퍼 (Triangles, 타일당 6개). 렌더러는 복사 없이 그대로 그림
+struct ChunkMesh
+{
+    std::vector<sf::Vertex> vertices;
+};
+
+// 타일 값 -> 색. 범위 밖 값은 바닥색
+struct TilePalette
+{
+    std::array<sf::Color, 2> colors{sf::Color(46, 52, 64),  // 0 바닥
+                                    sf::Color(70, 75, 85)}; // 1 벽
+
+    sf::Color at(int v) const { return (v >= 0 && v < int(colors.size())) ? colors[v] : colors[0]; }
+};
+
+// 타일 원점 계수와 정점 템플릿 (bakeLayout(projection)으로 만듦)
+// origin(tx, ty) = (tx * ax + ty * bx, tx * ay + ty * by), 정점 = origin + offsets[k]
+struct BakeLayout
+{
+    float ax{0.f}, ay{0.f}, bx{0.f}, by{0.f};
+    std::array<sf::Vector2f, 6> offsets{};
+};
+
+// 투영에서 레이아웃을 뽑음. 선형 투영(월드 원점 -> 화면 원점)이면 타일 (1, 0), (0, 1) 방향과 타일 네 모서리로 충분
+template <geometry::ScreenProjection P>
+BakeLayout bakeLayout(const P &proj)
+{
+    const float ts = float(proj.tileSize());
+    const geometry::Vec2 o = proj.toScreen({0.f, 0.f});
+    const auto at = [&](float fx, float fy) {
+        const geometry::Vec2 p = proj.toScreen({fx * ts, fy * ts});
+        return sf::Vector2f{p.x - o.x, p.y - o.y};
+    };
+    BakeLayout l{};
+    const sf::Vector2f a = at(1.f, 0.f), b = at(0.f, 1.f);
+    l.ax = a.x;
+    l.ay = a.y;
+    l.bx = b.x;
+    l.by = b.y;
+    // two triangles per tile: (0,0) (1,0) (1,1) / (0,0) (1,1) (0,1)
+    l.offsets = {at(0.f, 0.f), at(1.f, 0.f), at(1.f, 1.f), at(0.f, 0.f), at(1.f, 1.f), at(0.f, 1.f)};
+    return l;
+}
+
+// 한 행(ty 고정, tx = x0..x0+n-1)의 타일 원점을 ox/oy에 계산
+inline void rowOrigins(const BakeLayout &l, int x0, int ty, int n, float *ox, float *oy)
+{
+    const float row_x = float(ty) * l.bx;
+    const float row_y = float(ty) * l.by;
+    int i = 0;
+#if FOLIO_BAKE_SSE2
+    const __m128 ax = _mm_set1_ps(l.ax);
+    const __m128 ay = _mm_set1_ps(l.ay);
+    const __m128 rx = _mm_set1_ps(row_x);
+    const __m128 ry = _mm_set1_ps(row_y);
+    const __m128 step = _mm_set1_ps(4.f);
+    __m128 tx = _mm_add_ps(_mm_set1_ps(float(x0)), _mm_setr_ps(0.f, 1.f, 2.f, 3.f));
+    for (; i + 4 <= n; i += 4)
+    {
+        _mm_storeu_ps(ox + i, _mm_add_ps(_mm_mul_ps(tx, ax), rx));
+        _mm_storeu_ps(oy + i, _mm_add_ps(_mm_mul_ps(tx, ay), ry));
+        tx = _mm_add_ps(tx, step);
+    }
+#endif
+    for (; i < n; ++i)
+    {
+        const float tx = float(x0 + i);
+        ox[i] = tx * l.ax + row_x;
+        oy[i] = tx * l.ay + row_y;
+    }
+}
+
+// 조명 값(0..255)을 색에 곱함. 255면 그대로
+inline sf::Color litColor(sf::Color c, std::uint8_t light)
+{
+    const auto mul = [light](std::uint8_t v) { return std::uint8_t((unsigned(v) * light + 127) / 255); };
+    return sf::Color(mul(c.r), mul(c.g), mul(c.b), c.a);
+}
+
+// cols x rows 격자(tiles, 행 간격 stride)를 out에 굽는다. (gx0, gy0)은 격자 첫 칸의 layout 좌표
+// light가 있으면 tiles와 같은 모양(행 간격 light_stride)의 조명 격자로 색을 곱함
+// 출력 크기는 한 번에 맞추고 행 단위로 채움
+inline void bakeGrid(const int *tiles, int stride, int gx0, int gy0, int cols, int rows,
+                     const BakeLayout &layout, const TilePalette &palette, std::vector<sf::Vertex> &out,
+                     const std::uint8_t *light = nullptr, int light_stride = 0)
+{
+    if (cols <= 0 || rows <= 0)
+    {
+        out.clear();
+        return;
+    }
+    out.resize(size_t(cols) * size_t(rows) * 6);
+
+    std::vector<float> ox(static_cast<size_t>(cols));
+    std::vector<float> oy(static_cast<size_t>(cols));
+    sf::Vertex *dst = out.data();
+    for (int r = 0; r < rows; ++r)
+    {
+        rowOrigins(layout, gx0, gy0 + r, cols, ox.data(), oy.data());
+        const int *row = tiles + size_t(r) * stride;
+        const std::uint8_t *lrow = light ? light + size_t(r) * light_stride : nullptr;
+        for (int i = 0; i < cols; ++i)
+        {
+            const sf::Color c = lrow ? litColor(palette.at(row[i]), lrow[i]) : palette.at(row[i]);
+            for (int k = 0; k < 6; ++k)
+            {
+                dst[k].position = sf::Vector2f{ox[i] + layout.offsets[k].x, oy[i] + layout.offsets[k].y};
+                dst[k].color = c;
+            }
+            dst += 6;
+        }
+    }
+}
+
+// [x0, x1) x [y0, y1) 타일을 out에 굽는다. light는 맵 전체 크기의 조명 격자 (없으면 nullptr)
+inline void bakeTiles(const TileMap &map, int x0, int y0, int x1, int y1,
+                      const BakeLayout &layout, const TilePalette &palette, std::vector<sf::Vertex> &out,
+                      const std::uint8_t *light = nullptr)
+{
+    const size_t at = size_t(y0) * map.w + x0;
+    bakeGrid(map.tiles.data() + at, map.w, x0, y0, x1 - x0, y1 - y0, layout, palette, out,
+             light ? light + at : nullptr, map.w);
+}
+
+// LOD: factor x factor 타일 블록 하나를 super-tile 하나로 그림
+enum class LodRule : std::uint8_t
+{
+    Majority, // 가장 많은 값 (동률이면 큰 값, 벽이 우선)
+    Priority  // 블록 안의 가장 큰 값 (얇은 벽도 남음)
+};
+
+// 타일 좌표계 layout을 factor배 super-tile 좌표계로
+inline BakeLayout scaledLayout(const BakeLayout &l, int factor)
+{
+    const float f = float(factor);
+    BakeLayout s{l.ax * f, l.ay * f, l.bx * f, l.by * f, l.offsets};
+    for (auto &o : s.offsets)
+    {
+        o = sf::Vector2f{o.x * f, o.y * f};
+    }
+    return s;
+}
+
+// [x0, x1) x [y0, y1)를 factor 단위 블록으로 줄여 out에 (행 우선, cols 열). x0, y0은 factor의 배수
+// 맵 가장자리에서 잘린 블록은 안쪽 타일만 셈. 팔레트 밖 값은 0으로 취급
+inline int downsampleTiles(const TileMap &map, int x0, int y0, int x1, int y1, int factor, LodRule rule,
+                           std::vector<int> &out)
+{
+    constexpr int kValues = 16;
+    const int cols = (x1 - x0 + factor - 1) / factor;
+    const int rows = (y1 - y0 + factor - 1) / factor;
+    out.resize(size_t(std::max(cols, 0)) * size_t(std::max(rows, 0)));
+
+    for (int r = 0; r < rows; ++r)
+    {
+        const int by0 = y0 + r * factor;
+        const int by1 = std::min(y1, by0 + factor);
+        for (int c = 0; c < cols; ++c)
+        {
+            const int bx0 = x0 + c * factor;
+            const int bx1 = std::min(x1, bx0 + factor);
+            std::array<int, kValues> counts{};
+            int best = 0;
+            for (int y = by0; y < by1; ++y)
+            {
+                const int *row = map.tiles.data() + size_t(y) * map.w;
+                for (int x = bx0; x < bx1; ++x)
+                {
+                    const int v = (row[x] >= 0 && row[x] < kValues) ? row[x] : 0;
+                    ++counts[v];
+                    best = std::max(best, v);
+                }
+            }
+            if (rule == LodRule::Majority)
+            {
+                best = 0;
+                for (int v = 1; v < kValues; ++v)
+                {
+                    if (counts[v] > 0 && counts[v] >= counts[best])
+                    {
+                        best = v;
+                    }
+                }
+            }
+            out[size_t(r) * cols + c] = best;
+        }
+    }
+    return cols;
+}
+
+// downsampleTiles와 같은 블록 단위로 조명 평균 (light는 맵 전체 크기)
+inline void downsampleLight(const TileMap &map, const std::uint8_t *light, int x0, int y0, int x1, int y1, int factor,
+                            std::vector<std::uint8_t> &out)
+{
+    const int cols = (x1 - x0 + factor - 1) / factor;
+    const int rows = (y1 - y0 + factor - 1) / factor;
+    out.resize(size_t(std::max(cols, 0)) * size_t(std::max(rows, 0)));
+
+    for (int r = 0; r < rows; ++r)
+    {
+        const int by0 = y0 + r * factor;
+        const int by1 = std::min(y1, by0 + factor);
+        for (int c = 0; c < cols; ++c)
+        {
+            const int bx0 = x0 + c * factor;
+            const int bx1 = std::min(x1, bx0 + factor);
+            unsigned sum = 0;
+            for (int y = by0; y < by1; ++y)
+            {
+                const std::uint8_t *row = light + size_t(y) * map.w;
+                for (int x = bx0; x < bx1; ++x)
+                {
+                    sum += row[x];
+                }
+            }
+            const unsigned n = unsigned((bx1 - bx0) * (by1 - by0));
+            out[size_t(r) * cols + c] = std::uint8_t((sum + n / 2) / n);
+        }
+    }
+}
+} // namespace folio::world
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace folio::world
+{
+struct ChunkKey
+{
+    bool operator==(const ChunkKey &chunk_key) const
+    {
+        return x == chunk_key.x && y == chunk_key.y;
+    };
+
+    int x, y;
+};
+
+enum class ChunkState : std::uint8_t
+{
+    Absent,  // 메쉬 없음, 요청도 없음
+    Pending, // 베이크 대기 중 (이전 메쉬가 있으면 그동안 그걸 그림)
+    Ready,   // 메쉬가 최신
+    Stale    // 메쉬가 있지만 오래됨, 다시 요청해야 함
+};
+
+template <typename T>
+struct ChunkSlot
+{
+    ChunkState state{ChunkState::Absent};
+    std::uint32_t generation{0}; // 무효화될 때마다 증가. 오래된 베이크 결과를 버리는 데 씀
+    T value{};
+};
+
+// 크기가 정해진 맵용 2D 청크 슬롯 테이블. 조회는 인덱스 계산 한 번
+template <typename T>
+class DenseChunkGrid
+{
+public:
+    void reset(int w, int h)
+    {
+        w_ = w;
+        h_ = h;
+        slots_.clear();
+        slots_.resize(size_t(w) * size_t(h));
+    }
+
+    bool contains(const ChunkKey &k) const { return k.x >= 0 && k.y >= 0 && k.x < w_ && k.y < h_; }
+
+    // 범위 밖이면 nullptr
+    ChunkSlot<T> *find(const ChunkKey &k) { return contains(k) ? &slots_[size_t(k.y) * w_ + k.x] : nullptr; }
+    const ChunkSlot<T> *find(const ChunkKey &k) const { return contains(k) ? &slots_[size_t(k.y) * w_ + k.x] : nullptr; }
+
+    // 범위 안이어야 함
+    ChunkSlot<T> &at(const ChunkKey &k) { return slots_[size_t(k.y) * w_ + k.x]; }
+    const ChunkSlot<T> &at(const ChunkKey &k) const { return slots_[size_t(k.y) * w_ + k.x]; }
+
+    int width() const { return w_; }
+    int height() const { return h_; }
+
+    template <typename Fn>
+    void forEach(Fn &&fn)
+    {
+        for (int y = 0; y < h_; ++y)
+        {
+            for (int x = 0; x < w_; ++x)
+            {
+                fn(ChunkKey{x, y}, slots_[size_t(y) * w_ + x]);
+            }
+        }
+    }
+
+private:
+    int w_{0}, h_{0};
+    std::vector<ChunkSlot<T>> slots_;
+};
+
+} // namespace folio::world
@@ -1,129 +1,245 @@
 #pragma once
 
 #include "src/concurrency/job_system.hpp"
+#include "src/geometry/projection.hpp"
 #include "src/geometry/types.hpp"
+#include "src/metrics/metrics.hpp"
+#include "chunk_bake.hpp"
+#include "chunk_grid.hpp"
+#include "lighting.hpp"
+#include "occupancy.hpp"
 #include "tile_map.hpp"
-#include "iso.hpp"
 #include <SFML/Graphics.hpp>
-#include <SFML/Graphics/VertexArray.hpp>
 #include <SFML/Graphics/RenderTarget.hpp>
 #include <SFML/Graphics/View.hpp>
 #include <algorithm>
+#include <array>
 #include <cmath>
-#include <unordered_map>
-#include <unordered_set>
 
 namespace folio::world
 {
-struct ChunkKey
-{
-    bool operator==(const ChunkKey &chunk_key) const
-    {
-        return x == chunk_key.x && y == chunk_key.y;
-    };
+// LOD 단계 L: 2^L x 2^L 타일을 super-tile 하나로, 청크 하나는 (chunk << L) 타일을 덮음
+// 그래서 어느 단계든 화면에 보이는 청크 수와 청크당 정점 수가 거의 같음
+constexpr int kLodLevels = 3; // 1x1, 2x2, 4x4
 
-    int x, y;
+struct LodPolicy
+{
+    // view의 월드 단위/픽셀이 2^L * (1 + hysteresis)를 넘으면 L단계로 올리고,
+    // 2^L * (1 - hysteresis) 아래로 내려가면 한 단계 내림
+    float hysteresis{0.15f};
+    LodRule rule{LodRule::Majority};
 };
 
-struct ChunkKeyHash
+// 모든 ChunkCache 합계
+struct ChunkMetrics
 {
-    size_t operator()(const ChunkKey &chunk_key) const
-    {
-        return (chunk_key.x * 73856093u) ^ (chunk_key.y * 19349663u);
-    };
+    metrics::Counter &bakes = metrics::counter("chunks.bakes");
+    metrics::Counter &uniform_bakes = metrics::counter("chunks.uniform_bakes"); // 전부 바닥/벽이라 타일을 읽지 않은 베이크
+    metrics::Gauge &meshes = metrics::gauge("chunks.meshes");     // 메쉬를 들고 있는 청크 수
+    metrics::Gauge &vertices = metrics::gauge("chunks.vertices"); // 들고 있는 정점 수
 };
 
-class ChunkCache
+inline ChunkMetrics &chunkMetrics()
+{
+    static ChunkMetrics m;
+    return m;
+}
+
+// Projection: geometry::TopDownProjection, IsoProjection 등. 컬링과 베이크가 투영마다 특수화됨
+template <geometry::ScreenProjection Projection>
+class BasicChunkCache
 {
 public:
-    ChunkCache(const TileMap &map, int chunk_tiles = 32)
-        : tile_map_(map), chunk_(chunk_tiles) {}
+    BasicChunkCache(const TileMap &map, Projection proj, int chunk_tiles = 32, LodPolicy lod = {})
+        : tile_map_(map), proj_(proj), chunk_(chunk_tiles), policy_(lod)
+    {
+        for (int l = 0; l < kLodLevels; ++l)
+        {
+            const int span = chunk_tiles << l;
+            grids_[l].reset(std::max(1, (map.w + span - 1) / span), std::max(1, (map.h + span - 1) / span));
+        }
+        const BakeLayout base = bakeLayout(proj_);
+        for (int l = 0; l < kLodLevels; ++l)
+        {
+            layouts_[l] = scaledLayout(base, 1 << l);
+        }
+    }
 
-    void setIsometric(IsoDims dims)
+    ~BasicChunkCache()
     {
-        isometric_ = true;
-        iso_ = dims;
+        ChunkMetrics &m = chunkMetrics();
+        for (auto &grid : grids_)
+        {
+            grid.forEach([&](const ChunkKey &, ChunkSlot<Entry> &slot) {
+                if (!slot.value.mesh.vertices.empty())
+                {
+                    m.meshes.add(-1);
+                    m.vertices.add(-std::int64_t(slot.value.mesh.vertices.size()));
+                }
+            });
+        }
     }
 
-    // 보이는 청크를 큐에 추가하고, 준비되지 않은 청크는 jobs로 베이크를 제출
-    void appendVisibleRange(const sf::View &cam, concurrency::JobSystem &jobs)
+    const Projection &projection() const { return proj_; }
+
+    // 현재 view의 월드 단위/픽셀(1 = 원래 크기)로 LOD 단계를 고름. 경계 근처에서 깜빡이지 않도록 hysteresis
+    void updateLod(float world_per_pixel)
+    {
+        int l = lod_;
+        while (l + 1 < kLodLevels && world_per_pixel > float(2 << l) * (1.f + policy_.hysteresis))
+        {
+            ++l;
+        }
+        while (l > 0 && world_per_pixel < float(1 << l) * (1.f - policy_.hysteresis))
+        {
+            --l;
+        }
+        lod_ = l;
+    }
+
+    int lod() const { return lod_; }
+    int chunkTiles() const { return chunk_; }
+
+    // 베이크할 때 곱할 조명. 이미 구운 청크는 모두 다시 구움
+    void setLighting(const TileLighting *lighting)
     {
-        visibleRange(cam, [&](const ChunkKey &key) {
-            if (cache_.find(key) == cache_.end() && pending_.find(key) == pending_.end())
+        lighting_ = lighting;
+        for (int cy = 0; cy < grids_[0].height(); ++cy)
+        {
+            for (int cx = 0; cx < grids_[0].width(); ++cx)
             {
-                pending_.insert(key);
-                jobs.submit([this, key]() {
-                    auto va = buildChunk(key);
-                    cache_[key] = std::move(va);
-                    pending_.erase(key);
-                });
+                invalidateChunk(cx, cy);
             }
+        }
+    }
+
+    // 베이크 전에 볼 벽 요약. 전부 바닥이거나 전부 벽인 청크는 타일을 읽지 않고 한 값으로 구움
+    // 맵의 타일을 바꿀 때 occupancy도 같이 갱신되어야 함
+    void setOccupancy(const TileOccupancy *occupancy) { occupancy_ = occupancy; }
+
+    // 보이는 청크를 큐에 추가하고, 준비되지 않은 청크는 jobs로 베이크를 제출
+    // 화면 안은 Visible, 한 청크 바깥 여유 영역은 Prefetch 우선순위
+    void appendVisibleRange(const sf::View &cam, concurrency::JobSystem &jobs)
+    {
+        visibleRange(cam, 0, lod_, [&](const ChunkKey &key) { request(key, lod_, concurrency::Priority::Visible, jobs); });
+        visibleRange(cam, 1, lod_, [&](const ChunkKey &key) { request(key, lod_, concurrency::Priority::Prefetch, jobs); });
+        // 새 단계가 화면을 다 채울 때까지는 이전 단계를 그림
+        if (drawn_lod_ != lod_ && ready(cam))
+        {
+            drawn_lod_ = lod_;
+        }
+    }
+
+    // 아직 보이지 않는 영역(맵 전환 목적지 등)을 미리 베이크. 기본은 Prefetch 우선순위
+    void prefetch(const sf::View &cam, concurrency::JobSystem &jobs,
+                  concurrency::Priority prio = concurrency::Priority::Prefetch)
+    {
+        visibleRange(cam, 1, lod_, [&](const ChunkKey &key) { request(key, lod_, prio, jobs); });
+    }
+
+    // cam 화면 안의 청크가 현재 LOD 단계로 모두 베이크되었는지
+    bool ready(const sf::View &cam) const
+    {
+        bool all = true;
+        visibleRange(cam, 0, lod_, [&](const ChunkKey &key) {
+            all = all && grids_[lod_].at(key).state == ChunkState::Ready;
         });
+        return all;
+    }
+
+    // 월드 좌표 pos를 중심으로 하는 이 캐시의 투영 공간 view
+    sf::View viewAt(const geometry::Vec2 &pos, const sf::Vector2f &size) const
+    {
+        const geometry::Vec2 c = proj_.toScreen(pos);
+        return sf::View(sf::FloatRect(sf::Vector2f{c.x - size.x * 0.5f, c.y - size.y * 0.5f}, size));
     }
 
     void drawVisible(sf::RenderTarget &target, const sf::View &cam) const
     {
-        visibleRange(cam, [&](const ChunkKey &key) {
-            auto it = cache_.find(key);
-            if (it != cache_.end())
+        // Stale/Pending 청크도 이전 메쉬가 있으면 새 베이크가 끝날 때까지 그대로 그림
+        const int l = drawn_lod_;
+        visibleRange(cam, 1, l, [&](const ChunkKey &key) {
+            const auto &v = grids_[l].at(key).value.mesh.vertices;
+            if (!v.empty())
             {
-                target.draw(it->second);
+                target.draw(v.data(), v.size(), sf::PrimitiveType::Triangles);
             }
         });
     }
 
     void invalidateTile(int tx, int ty)
     {
-        const int cx = std::clamp(tx / chunk_, 0, std::max(1, (tile_map_.w + chunk_ - 1) / chunk_) - 1);
-        const int cy = std::clamp(ty / chunk_, 0, std::max(1, (tile_map_.h + chunk_ - 1) / chunk_) - 1);
-        ChunkKey key{cx, cy};
-        cache_.erase(key);
-        pending_.erase(key);
+        const int cx = std::clamp(tx / chunk_, 0, grids_[0].width() - 1);
+        const int cy = std::clamp(ty / chunk_, 0, grids_[0].height() - 1);
+        invalidateChunk(cx, cy);
+    }
+
+    // 기본 단계 청크 좌표. 그 청크를 덮는 모든 LOD 단계의 청크를 무효화
+    void invalidateChunk(int cx, int cy)
+    {
+        for (int l = 0; l < kLodLevels; ++l)
+        {
+            ChunkSlot<Entry> *slot = grids_[l].find(ChunkKey{cx >> l, cy >> l});
+            if (!slot || slot->state == ChunkState::Absent)
+            {
+                continue;
+            }
+            // 대기 중인 베이크는 generation이 달라져서 버려짐
+            ++slot->generation;
+            slot->state = slot->value.mesh.vertices.empty() ? ChunkState::Absent : ChunkState::Stale;
+        }
     }
 
 private:
-    void visibleRange(const sf::View &cam, auto &&fn) const
+    struct Entry
     {
-        const int tile_size = tile_map_.tile_size;
-        const int chunk_tiles = chunk_;
+        ChunkMesh mesh{};
+        concurrency::Priority prio{concurrency::Priority::Housekeeping}; // Pending일 때 제출된 우선순위
+    };
 
+    void request(const ChunkKey &key, int level, concurrency::Priority prio, concurrency::JobSystem &jobs)
+    {
+        ChunkSlot<Entry> &slot = grids_[level].at(key);
+        if (slot.state == ChunkState::Ready ||
+            (slot.state == ChunkState::Pending && slot.value.prio <= prio))
+        {
+            return;
+        }
+        // 더 높은 우선순위로 다시 제출. 먼저 끝난 쪽이 베이크하고 나머지는 건너뜀
+        slot.state = ChunkState::Pending;
+        slot.value.prio = prio;
+        auto bake = [this, key, level, gen = slot.generation]() {
+            ChunkSlot<Entry> &s = grids_[level].at(key);
+            if (s.state != ChunkState::Pending || s.generation != gen)
+            {
+                return;
+            }
+            ChunkMesh mesh = buildChunk(key, level);
+            ChunkMetrics &m = chunkMetrics();
+            m.bakes.add();
+            m.meshes.add(s.value.mesh.vertices.empty() ? 1 : 0);
+            m.vertices.add(std::int64_t(mesh.vertices.size()) - std::int64_t(s.value.mesh.vertices.size()));
+            s.value.mesh = std::move(mesh);
+            s.state = ChunkState::Ready;
+        };
+        jobs.submit(std::move(bake), prio);
+    }
+
+    // pad: 화면 가장자리 바깥으로 추가할 청크 수
+    void visibleRange(const sf::View &cam, int pad, int level, auto &&fn) const
+    {
+        const float chunk_world = float((chunk_ << level) * tile_map_.tile_size);
         const auto cc = cam.getCenter();
         const auto cs = cam.getSize();
-        const float left = cc.x - cs.x * 0.5f;
-        const float top = cc.y - cs.y * 0.5f;
-        const float right = cc.x + cs.x * 0.5f;
-        const float bottom = cc.y + cs.y * 0.5f;
+        // 화면 사각형을 월드로 되돌려 덮는 청크 범위
+        const geometry::AABB w = geometry::worldBounds(proj_, {cc.x - cs.x * 0.5f, cc.y - cs.y * 0.5f, cs.x, cs.y});
 
-        const int max_cx = std::max(1, (tile_map_.w + chunk_tiles - 1) / chunk_tiles);
-        const int max_cy = std::max(1, (tile_map_.h + chunk_tiles - 1) / chunk_tiles);
-
-        int cx0, cy0, cx1, cy1;
-        if (!isometric_)
-        {
-            const int chunk_world = chunk_tiles * tile_size;
-            cx0 = std::clamp(int(std::floor(left / chunk_world)) - 1, 0, max_cx - 1);
-            cy0 = std::clamp(int(std::floor(top / chunk_world)) - 1, 0, max_cy - 1);
-            cx1 = std::clamp(int(std::floor(right / chunk_world)) + 1, 0, max_cx - 1);
-            cy1 = std::clamp(int(std::floor(bottom / chunk_world)) + 1, 0, max_cy - 1);
-        }
-        else
-        {
-            // transform iso view rect corners back to world, then to fractional tile indices
-            auto pLT = isoToWorld(left, top, tile_size, iso_);
-            auto pRT = isoToWorld(right, top, tile_size, iso_);
-            auto pRB = isoToWorld(right, bottom, tile_size, iso_);
-            auto pLB = isoToWorld(left, bottom, tile_size, iso_);
-
-            const float fx_min = std::min(std::min(pLT.x, pRT.x), std::min(pRB.x, pLB.x)) / float(tile_size);
-            const float fx_max = std::max(std::max(pLT.x, pRT.x), std::max(pRB.x, pLB.x)) / float(tile_size);
-            const float fy_min = std::min(std::min(pLT.y, pRT.y), std::min(pRB.y, pLB.y)) / float(tile_size);
-            const float fy_max = std::max(std::max(pLT.y, pRT.y), std::max(pRB.y, pLB.y)) / float(tile_size);
-
-            cx0 = std::clamp(int(std::floor(fx_min / chunk_tiles)) - 1, 0, max_cx - 1);
-            cy0 = std::clamp(int(std::floor(fy_min / chunk_tiles)) - 1, 0, max_cy - 1);
-            cx1 = std::clamp(int(std::floor(fx_max / chunk_tiles)) + 1, 0, max_cx - 1);
-            cy1 = std::clamp(int(std::floor(fy_max / chunk_tiles)) + 1, 0, max_cy - 1);
-        }
+        const int max_cx = grids_[level].width();
+        const int max_cy = grids_[level].height();
+        const int cx0 = std::clamp(int(std::floor(w.x / chunk_world)) - pad, 0, max_cx - 1);
+        const int cy0 = std::clamp(int(std::floor(w.y / chunk_world)) - pad, 0, max_cy - 1);
+        const int cx1 = std::clamp(int(std::floor((w.x + w.w) / chunk_world)) + pad, 0, max_cx - 1);
+        const int cy1 = std::clamp(int(std::floor((w.y + w.h) / chunk_world)) + pad, 0, max_cy - 1);
 
         for (int cy = cy0; cy <= cy1; ++cy)
         {
@@ -134,72 +250,79 @@ private:
         }
     }
 
-    sf::VertexArray buildChunk(const ChunkKey &key) const
+    ChunkMesh buildChunk(const ChunkKey &key, int level) const
     {
-        const int ts = tile_map_.tile_size;
-        const int cx = key.x * chunk_;
-        const int cy = key.y * chunk_;
-        const int ex = std::min(tile_map_.w, cx + chunk_);
-        const int ey = std::min(tile_map_.h, cy + chunk_);
+        const int span = chunk_ << level;
+        const int cx = key.x * span;
+        const int cy = key.y * span;
+        const int ex = std::min(tile_map_.w, cx + span);
+        const int ey = std::min(tile_map_.h, cy + span);
 
-        sf::VertexArray va(sf::PrimitiveType::Triangles);
-        if (!isometric_)
+        const std::uint8_t *light = lighting_ ? lighting_->data() : nullptr;
+        ChunkMesh mesh;
+        const TileFill fill = occupancy_ ? occupancy_->fill(cx, cy, ex, ey) : TileFill::Mixed;
+        if (fill != TileFill::Mixed)
         {
-            for (int y = cy; y < ey; ++y)
-            {
-                for (int x = cx; x < ex; ++x)
-                {
-                    const int v = tile_map_.tiles[y * tile_map_.w + x];
-                    const sf::Color color = (v == 1) ? sf::Color(70, 75, 85)
-                                                     : sf::Color(46, 52, 64);
-                    const float px = float(x * ts);
-                    const float py = float(y * ts);
-                    // two triangles per tile
-                    va.append(sf::Vertex(sf::Vector2f{px, py}, color));
-                    va.append(sf::Vertex(sf::Vector2f{px + ts, py}, color));
-                    va.append(sf::Vertex(sf::Vector2f{px + ts, py + ts}, color));
-                    va.append(sf::Vertex(sf::Vector2f{px, py}, color));
-                    va.append(sf::Vertex(sf::Vector2f{px + ts, py + ts}, color));
-                    va.append(sf::Vertex(sf::Vector2f{px, py + ts}, color));
-                }
-            }
+            bakeUniform(fill == TileFill::Full ? 1 : 0, cx, cy, ex, ey, level, light, mesh);
+            return mesh;
         }
-        else
+        if (level == 0)
         {
-            const float half_w = iso_.w * 0.5f;
-            const float half_h = iso_.h * 0.5f;
-            for (int y = cy; y < ey; ++y)
-            {
-                for (int x = cx; x < ex; ++x)
-                {
-                    const int v = tile_map_.tiles[y * tile_map_.w + x];
-                    const sf::Color color = (v == 1) ? sf::Color(70, 75, 85)
-                                                     : sf::Color(46, 52, 64);
-                    auto top = tileToIso(x, y, iso_);
-                    sf::Vector2f p0{top.x, top.y};
-                    sf::Vector2f p1{top.x + half_w, top.y + half_h};
-                    sf::Vector2f p2{top.x, top.y + iso_.h};
-                    sf::Vector2f p3{top.x - half_w, top.y + half_h};
-                    // two triangles to form a diamond
-                    va.append(sf::Vertex(p0, color));
-                    va.append(sf::Vertex(p1, color));
-                    va.append(sf::Vertex(p2, color));
-                    va.append(sf::Vertex(p0, color));
-                    va.append(sf::Vertex(p2, color));
-                    va.append(sf::Vertex(p3, color));
-                }
-            }
+            bakeTiles(tile_map_, cx, cy, ex, ey, layouts_[0], palette_, mesh.vertices, light);
+            return mesh;
+        }
+        const int factor = 1 << level;
+        std::vector<int> super;
+        const int cols = downsampleTiles(tile_map_, cx, cy, ex, ey, factor, policy_.rule, super);
+        const int rows = cols > 0 ? int(super.size()) / cols : 0;
+        std::vector<std::uint8_t> super_light;
+        if (light)
+        {
+            downsampleLight(tile_map_, light, cx, cy, ex, ey, factor, super_light);
+        }
+        bakeGrid(super.data(), cols, cx / factor, cy / factor, cols, rows, layouts_[level], palette_, mesh.vertices,
+                 light ? super_light.data() : nullptr, cols);
+        return mesh;
+    }
+
+private:
+    // 같은 값 한 행을 stride 0으로 반복해서 구움. 조명만 타일마다 다름
+    void bakeUniform(int value, int cx, int cy, int ex, int ey, int level, const std::uint8_t *light, ChunkMesh &mesh) const
+    {
+        chunkMetrics().uniform_bakes.add();
+        const int factor = 1 << level;
+        const int cols = (ex - cx + factor - 1) / factor;
+        const int rows = (ey - cy + factor - 1) / factor;
+        const std::vector<int> row(size_t(std::max(cols, 0)), value);
+        if (level == 0)
+        {
+            bakeGrid(row.data(), 0, cx, cy, cols, rows, layouts_[0], palette_, mesh.vertices,
+                     light ? light + size_t(cy) * tile_map_.w + cx : nullptr, tile_map_.w);
+            return;
+        }
+        std::vector<std::uint8_t> super_light;
+        if (light)
+        {
+            downsampleLight(tile_map_, light, cx, cy, ex, ey, factor, super_light);
         }
-        return va;
+        bakeGrid(row.data(), 0, cx / factor, cy / factor, cols, rows, layouts_[level], palette_, mesh.vertices,
+                 light ? super_light.data() : nullptr, cols);
     }
 
 private:
     const TileMap &tile_map_;
+    Projection proj_;
     int chunk_;
-    bool isometric_{false};
-    IsoDims iso_{};
-    std::unordered_map<ChunkKey, sf::VertexArray, ChunkKeyHash> cache_;
-    std::unordered_set<ChunkKey, ChunkKeyHash> pending_;
+    LodPolicy policy_{};
+    int lod_{0};       // 베이크를 요청하는 단계
+    int drawn_lod_{0}; // 그리는 단계 (lod_가 화면을 다 채우면 따라감)
+    std::array<BakeLayout, kLodLevels> layouts_{};
+    TilePalette palette_{};
+    const TileLighting *lighting_{nullptr};
+    const TileOccupancy *occupancy_{nullptr};
+    std::array<DenseChunkGrid<Entry>, kLodLevels> grids_{};
 };
 
+using ChunkCache = BasicChunkCache<geometry::TopDownProjection>;
+using IsoChunkCache = BasicChunkCache<geometry::IsoProjection>;
 } // namespace folio::world
@@ -0,0 +1,349 @@
+#pragma once
+
+#include "src/concurrency/job_system.hpp"
+#include "tile_map.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace folio::world
+{
+using LightId = std::uint32_t;
+
+struct TileLight
+{
+    int x{0}, y{0};
+    std::uint8_t intensity{255};
+    bool active{false};
+};
+
+// 타일 단위 조명. 점광원에서 바닥 타일을 따라 BFS로 퍼뜨리고(벽은 빛을 받지만 막음),
+// 결과를 타일당 1바이트 격자에 둔다. 청크 베이크가 이 격자로 색을 곱함
+//
+// 광원 이동/벽 변경은 영향받는 사각형만 dirty로 모으고, update()가 그 영역의 타일을 복사해
+// 워커에서 다시 전파한 뒤 결과를 메인 큐(drain)에서 적용. 값이 실제로 바뀐 청크만 onChunk로 알림
+// 한 번에 한 배치만 돌고, 그동안 생긴 dirty는 다음 배치로 넘어감
+class TileLighting
+{
+public:
+    TileLighting(const TileMap &map, std::uint8_t ambient = 255, std::uint8_t falloff = 20)
+        : map_(map), ambient_(ambient), falloff_(std::max<std::uint8_t>(1, falloff)),
+          max_radius_((255 + falloff_ - 1) / falloff_)
+    {
+        rebuild();
+    }
+    TileLighting(const TileLighting &) = delete;
+    TileLighting &operator=(const TileLighting &) = delete;
+    ~TileLighting()
+    {
+        // 워커가 이 객체를 보고 있으면 끝날 때까지 대기 (적용 단계는 메인 큐에 남은 채로 버려짐)
+        while (alive_->computing.load(std::memory_order_acquire))
+        {
+            std::this_thread::yield();
+        }
+        alive_->dead.store(true, std::memory_order_release);
+    }
+
+    std::uint8_t level(int x, int y) const { return levels_[size_t(y) * map_.w + x]; }
+    const std::uint8_t *data() const { return levels_.data(); }
+    std::uint8_t ambient() const { return ambient_; }
+
+    LightId addLight(int x, int y, std::uint8_t intensity)
+    {
+        LightId id = LightId(lights_.size());
+        for (LightId i = 0; i < lights_.size(); ++i)
+        {
+            if (!lights_[i].active)
+            {
+                id = i;
+                break;
+            }
+        }
+        if (id == lights_.size())
+        {
+            lights_.push_back({});
+        }
+        lights_[id] = TileLight{x, y, intensity, true};
+        markLight(lights_[id]);
+        return id;
+    }
+
+    void moveLight(LightId id, int x, int y)
+    {
+        TileLight &l = lights_[id];
+        if (l.x == x && l.y == y)
+        {
+            return;
+        }
+        markLight(l);
+        l.x = x;
+        l.y = y;
+        markLight(l);
+    }
+
+    void removeLight(LightId id)
+    {
+        markLight(lights_[id]);
+        lights_[id].active = false;
+    }
+
+    // [x0, x1) x [y0, y1)의 타일이 바뀌었을 때 (벽 칠하기, 리로드, 스냅샷 복원)
+    void invalidateRegion(int x0, int y0, int x1, int y1)
+    {
+        for (const TileLight &l : lights_)
+        {
+            const int r = radius(l);
+            if (l.active && l.x + r >= x0 && l.x - r < x1 && l.y + r >= y0 && l.y - r < y1)
+            {
+                markLight(l);
+            }
+        }
+    }
+
+    bool busy() const { return alive_->computing.load(std::memory_order_acquire) || applying_; }
+    bool dirty() const { return !dirty_.empty(); }
+
+    // dirty 영역이 있고 진행 중인 배치가 없으면 워커에 보냄. 적용은 jobs.drain()에서
+    // onChunk(cx, cy): chunk_tiles 단위 청크의 조명이 바뀜
+    template <typename OnChunk>
+    void update(concurrency::JobSystem &jobs, int chunk_tiles, OnChunk on_chunk)
+    {
+        if (dirty_.empty() || busy())
+        {
+            return;
+        }
+        auto batch = std::make_shared<Batch>();
+        for (const Rect &r : dirty_)
+        {
+            batch->regions.push_back(snapshot(r));
+        }
+        dirty_.clear();
+        for (const TileLight &l : lights_)
+        {
+            if (l.active)
+            {
+                batch->lights.push_back(l);
+            }
+        }
+        batch->ambient = ambient_;
+        batch->falloff = falloff_;
+
+        applying_ = true;
+        alive_->computing.store(true, std::memory_order_release);
+        jobs.dispatch([this, batch, &jobs, chunk_tiles, on_chunk, alive = alive_]() {
+            for (Region &reg : batch->regions)
+            {
+                propagate(reg, batch->lights, batch->ambient, batch->falloff);
+            }
+            jobs.submit([this, batch, chunk_tiles, on_chunk, alive]() {
+                if (!alive->dead.load(std::memory_order_acquire))
+                {
+                    apply(*batch, chunk_tiles, on_chunk);
+                }
+            }, concurrency::Priority::Visible);
+            alive->computing.store(false, std::memory_order_release);
+        });
+    }
+
+private:
+    struct Rect
+    {
+        int x0, y0, x1, y1; // [x0, x1) x [y0, y1)
+    };
+
+    // 다시 계산할 사각형 r과, r에 빛이 닿을 수 있는 범위 e의 타일 복사본
+    struct Region
+    {
+        Rect r{}, e{};
+        std::vector<int> tiles;        // e 크기
+        std::vector<std::uint8_t> out; // r 크기, 결과
+    };
+
+    struct Batch
+    {
+        std::vector<Region> regions;
+        std::vector<TileLight> lights;
+        std::uint8_t ambient{255};
+        std::uint8_t falloff{1};
+    };
+
+    struct Alive
+    {
+        std::atomic<bool> computing{false};
+        std::atomic<bool> dead{false};
+    };
+
+    int radius(const TileLight &l) const { return (l.intensity + falloff_ - 1) / falloff_; }
+
+    Rect clampRect(Rect r) const
+    {
+        return Rect{std::max(0, r.x0), std::max(0, r.y0), std::min(map_.w, r.x1), std::min(map_.h, r.y1)};
+    }
+
+    void markLight(const TileLight &l)
+    {
+        if (!l.active)
+        {
+            return;
+        }
+        const int r = radius(l);
+        const Rect rect = clampRect(Rect{l.x - r, l.y - r, l.x + r + 1, l.y + r + 1});
+        if (rect.x0 >= rect.x1 || rect.y0 >= rect.y1)
+        {
+            return;
+        }
+        // 같은 광원이 여러 번 표시되는 경우가 흔해서 이미 덮인 사각형은 버림
+        for (const Rect &d : dirty_)
+        {
+            if (d.x0 <= rect.x0 && d.y0 <= rect.y0 && d.x1 >= rect.x1 && d.y1 >= rect.y1)
+            {
+                return;
+            }
+        }
+        dirty_.push_back(rect);
+    }
+
+    Region snapshot(const Rect &r) const
+    {
+        Region reg;
+        reg.r = r;
+        // r 밖 광원의 경로도 r에서 max_radius 안쪽에만 있음
+        reg.e = clampRect(Rect{r.x0 - max_radius_, r.y0 - max_radius_, r.x1 + max_radius_, r.y1 + max_radius_});
+        const int ew = reg.e.x1 - reg.e.x0;
+        reg.tiles.resize(size_t(ew) * (reg.e.y1 - reg.e.y0));
+        for (int y = reg.e.y0; y < reg.e.y1; ++y)
+        {
+            std::copy_n(map_.tiles.data() + size_t(y) * map_.w + reg.e.x0, ew,
+                        reg.tiles.data() + size_t(y - reg.e.y0) * ew);
+        }
+        return reg;
+    }
+
+    // 워커에서 실행. reg.tiles만 읽음
+    static void propagate(Region &reg, const std::vector<TileLight> &lights, std::uint8_t ambient, std::uint8_t falloff)
+    {
+        const Rect &r = reg.r;
+        const Rect &e = reg.e;
+        const int rw = r.x1 - r.x0;
+        const int ew = e.x1 - e.x0, eh = e.y1 - e.y0;
+        reg.out.assign(size_t(rw) * (r.y1 - r.y0), ambient);
+
+        std::vector<std::uint8_t> seen(size_t(ew) * eh, 0);
+        std::vector<std::pair<int, int>> frontier, next;
+        for (const TileLight &l : lights)
+        {
+            const int lr = (l.intensity + falloff - 1) / falloff;
+            if (l.x < e.x0 || l.y < e.y0 || l.x >= e.x1 || l.y >= e.y1 ||
+                l.x + lr < r.x0 || l.x - lr >= r.x1 || l.y + lr < r.y0 || l.y - lr >= r.y1)
+            {
+                continue;
+            }
+            std::fill(seen.begin(), seen.end(), 0);
+            frontier.assign(1, {l.x, l.y});
+            seen[size_t(l.y - e.y0) * ew + (l.x - e.x0)] = 1;
+            int value = l.intensity;
+            while (!frontier.empty() && value > 0)
+            {
+                next.clear();
+                for (const auto &[x, y] : frontier)
+                {
+                    if (x >= r.x0 && x < r.x1 && y >= r.y0 && y < r.y1)
+                    {
+                        std::uint8_t &o = reg.out[size_t(y - r.y0) * rw + (x - r.x0)];
+                        o = std::max(o, std::uint8_t(value));
+                    }
+                    // 벽은 빛을 받지만 더 퍼뜨리지 않음
+                    if (reg.tiles[size_t(y - e.y0) * ew + (x - e.x0)] == 1)
+                    {
+                        continue;
+                    }
+                    const int nb[4][2] = {{x + 1, y}, {x - 1, y}, {x, y + 1}, {x, y - 1}};
+                    for (const auto &n : nb)
+                    {
+                        if (n[0] < e.x0 || n[1] < e.y0 || n[0] >= e.x1 || n[1] >= e.y1)
+                        {
+                            continue;
+                        }
+                        std::uint8_t &s = seen[size_t(n[1] - e.y0) * ew + (n[0] - e.x0)];
+                        if (!s)
+                        {
+                            s = 1;
+                            next.push_back({n[0], n[1]});
+                        }
+                    }
+                }
+                frontier.swap(next);
+                value -= falloff;
+            }
+        }
+    }
+
+    // 메인에서 실행
+    template <typename OnChunk>
+    void apply(const Batch &batch, int chunk_tiles, OnChunk &on_chunk)
+    {
+        const int cw = (map_.w + chunk_tiles - 1) / chunk_tiles;
+        std::vector<int> changed;
+        for (const Region &reg : batch.regions)
+        {
+            const int rw = reg.r.x1 - reg.r.x0;
+            for (int y = reg.r.y0; y < reg.r.y1; ++y)
+            {
+                for (int x = reg.r.x0; x < reg.r.x1; ++x)
+                {
+                    std::uint8_t &cur = levels_[size_t(y) * map_.w + x];
+                    const std::uint8_t v = reg.out[size_t(y - reg.r.y0) * rw + (x - reg.r.x0)];
+                    if (cur != v)
+                    {
+                        cur = v;
+                        changed.push_back((y / chunk_tiles) * cw + x / chunk_tiles);
+                    }
+                }
+            }
+        }
+        std::sort(changed.begin(), changed.end());
+        changed.erase(std::unique(changed.begin(), changed.end()), changed.end());
+        for (const int c : changed)
+        {
+            on_chunk(c % cw, c / cw);
+        }
+        applying_ = false;
+    }
+
+    // 생성 시 전체를 동기적으로 계산
+    void rebuild()
+    {
+        levels_.assign(size_t(map_.w) * map_.h, ambient_);
+        dirty_.clear();
+        if (map_.w <= 0 || map_.h <= 0)
+        {
+            return;
+        }
+        Region all = snapshot(Rect{0, 0, map_.w, map_.h});
+        std::vector<TileLight> active;
+        for (const TileLight &l : lights_)
+        {
+            if (l.active)
+            {
+                active.push_back(l);
+            }
+        }
+        propagate(all, active, ambient_, falloff_);
+        levels_ = std::move(all.out);
+    }
+
+private:
+    const TileMap &map_;
+    std::uint8_t ambient_;
+    std::uint8_t falloff_;
+    int max_radius_;
+    std::vector<std::uint8_t> levels_;
+    std::vector<TileLight> lights_;
+    std::vector<Rect> dirty_;
+    bool applying_{false}; // 디스패치 ~ 적용 사이
+    std::shared_ptr<Alive> alive_{std::make_shared<Alive>()};
+};
+} // namespace folio::world
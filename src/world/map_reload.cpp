@@ -0,0 +1,183 @@
+#include "map_reload.hpp"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <system_error>
+
+#if defined(__linux__)
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace folio::world
+{
+bool readASCIIMap(const std::string &path, const std::string &id, int tile_size, TileMap &out)
+{
+    std::ifstream in(path);
+    if (!in)
+    {
+        return false;
+    }
+    std::vector<std::string> rows;
+    std::string line;
+    while (std::getline(in, line))
+    {
+        if (!line.empty() && line.back() == '\r')
+        {
+            line.pop_back();
+        }
+        rows.push_back(line);
+    }
+    while (!rows.empty() && rows.back().empty())
+    {
+        rows.pop_back();
+    }
+    // 저장 도중에 읽었거나 행 길이가 다르면 실패로 보고 다음 변경을 기다림
+    if (rows.empty() || rows.front().empty())
+    {
+        return false;
+    }
+    for (const auto &r : rows)
+    {
+        if (r.size() != rows.front().size())
+        {
+            return false;
+        }
+    }
+    out = fromASCII(id, tile_size, rows);
+    return true;
+}
+
+std::vector<TileChange> diffTiles(const TileMap &live, const TileMap &next)
+{
+    std::vector<TileChange> changes;
+    const size_t row_bytes = size_t(live.w) * sizeof(int);
+    for (int y = 0; y < live.h; ++y)
+    {
+        const int *a = live.tiles.data() + size_t(y) * live.w;
+        const int *b = next.tiles.data() + size_t(y) * live.w;
+        if (std::memcmp(a, b, row_bytes) == 0)
+        {
+            continue;
+        }
+        for (int x = 0; x < live.w; ++x)
+        {
+            if (a[x] != b[x])
+            {
+                changes.push_back(TileChange{x, y, b[x]});
+            }
+        }
+    }
+    return changes;
+}
+
+FileWatcher::FileWatcher(std::string path, float poll_interval)
+    : path_(std::move(path)), poll_interval_(poll_interval)
+{
+    const std::filesystem::path p(path_);
+    name_ = p.filename().string();
+#if defined(__linux__)
+    inotify_fd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (inotify_fd_ >= 0)
+    {
+        const std::string dir = p.has_parent_path() ? p.parent_path().string() : std::string(".");
+        if (inotify_add_watch(inotify_fd_, dir.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0)
+        {
+            close(inotify_fd_);
+            inotify_fd_ = -1;
+        }
+    }
+#endif
+    if (inotify_fd_ < 0)
+    {
+        pollStat(); // 기준값
+    }
+}
+
+FileWatcher::~FileWatcher()
+{
+#if defined(__linux__)
+    if (inotify_fd_ >= 0)
+    {
+        close(inotify_fd_);
+    }
+#endif
+}
+
+bool FileWatcher::changed(float dt)
+{
+#if defined(__linux__)
+    if (inotify_fd_ >= 0)
+    {
+        bool hit = false;
+        alignas(inotify_event) char buf[4096];
+        for (;;)
+        {
+            const ssize_t n = read(inotify_fd_, buf, sizeof(buf));
+            if (n <= 0)
+            {
+                break;
+            }
+            for (ssize_t i = 0; i < n;)
+            {
+                const auto *ev = reinterpret_cast<const inotify_event *>(buf + i);
+                if (ev->len > 0 && name_ == ev->name)
+                {
+                    hit = true;
+                }
+                i += ssize_t(sizeof(inotify_event) + ev->len);
+            }
+        }
+        return hit;
+    }
+#endif
+    since_poll_ += dt;
+    if (since_poll_ < poll_interval_)
+    {
+        return false;
+    }
+    since_poll_ = 0.f;
+    return pollStat();
+}
+
+bool FileWatcher::pollStat()
+{
+    std::error_code ec;
+    const auto mtime = std::filesystem::last_write_time(path_, ec);
+    if (ec)
+    {
+        return false;
+    }
+    const auto size = std::filesystem::file_size(path_, ec);
+    if (ec || (mtime == mtime_ && size == size_))
+    {
+        return false;
+    }
+    mtime_ = mtime;
+    size_ = size;
+    return true;
+}
+
+bool MapReloader::poll(const TileMap &live, float dt, std::vector<TileChange> &changes)
+{
+    changes.clear();
+    if (!watcher_.changed(dt))
+    {
+        return false;
+    }
+    TileMap next;
+    if (!readASCIIMap(watcher_.path(), live.id, tile_size_, next))
+    {
+        std::fprintf(stderr, "map reload: cannot read %s\n", watcher_.path().c_str());
+        return false;
+    }
+    if (next.w != live.w || next.h != live.h)
+    {
+        std::fprintf(stderr, "map reload: %s changed size (%dx%d -> %dx%d), restart to apply\n",
+                     watcher_.path().c_str(), live.w, live.h, next.w, next.h);
+        return false;
+    }
+    changes = diffTiles(live, next);
+    return !changes.empty();
+}
+} // namespace folio::world
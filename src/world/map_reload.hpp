@@ -0,0 +1,61 @@
+#pragma once
+
+#include "tile_map.hpp"
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace folio::world
+{
+// ASCII 맵 파일을 fromASCII로 읽음 (행 길이가 모두 같아야 함). 실패하면 false
+bool readASCIIMap(const std::string &path, const std::string &id, int tile_size, TileMap &out);
+
+// live와 next(같은 크기)에서 값이 다른 타일. 같은 행은 통째로 비교해서 건너뜀
+std::vector<TileChange> diffTiles(const TileMap &live, const TileMap &next);
+
+// 파일 하나의 변경 감지. Linux는 inotify로 상위 디렉터리를 감시하고(저장 시 rename하는 에디터 대응),
+// 그 외에는 수정 시각/크기를 주기적으로 비교. changed()는 블로킹하지 않음
+class FileWatcher
+{
+public:
+    explicit FileWatcher(std::string path, float poll_interval = 0.25f);
+    ~FileWatcher();
+    FileWatcher(const FileWatcher &) = delete;
+    FileWatcher &operator=(const FileWatcher &) = delete;
+
+    // dt: 지난 호출 이후 경과 시간 (polling 간격용)
+    bool changed(float dt);
+    bool usingInotify() const { return inotify_fd_ >= 0; }
+    const std::string &path() const { return path_; }
+
+private:
+    bool pollStat();
+
+private:
+    std::string path_;
+    std::string name_; // 디렉터리 이벤트에서 비교할 파일 이름
+    int inotify_fd_{-1};
+    float poll_interval_;
+    float since_poll_{0.f};
+    std::filesystem::file_time_type mtime_{};
+    std::uintmax_t size_{0};
+};
+
+// 맵 파일이 바뀌면 다시 읽어서 live와의 차이만 돌려줌
+class MapReloader
+{
+public:
+    MapReloader(std::string path, int tile_size) : watcher_(std::move(path)), tile_size_(tile_size) {}
+
+    // 바뀐 타일이 있으면 true. 파일을 읽지 못했거나 맵 크기가 달라졌으면 false (다음 저장 때 다시 시도)
+    bool poll(const TileMap &live, float dt, std::vector<TileChange> &changes);
+
+    const FileWatcher &watcher() const { return watcher_; }
+
+private:
+    FileWatcher watcher_;
+    int tile_size_;
+};
+} // namespace folio::world
@@ -0,0 +1,187 @@
+#pragma once
+
+#include "tile_map.hpp"
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <vector>
+
+namespace folio::world
+{
+// 영역 요약
+enum class TileFill : std::uint8_t
+{
+    Empty, // 벽 없음 (전부 바닥)
+    Full,  // 전부 벽
+    Mixed
+};
+
+// 벽 타일 요약: 청크별 벽 수 + 8x8 블록별 64비트 마스크 (비트 = (y % 8) * 8 + x % 8)
+// 레이캐스트/충돌/베이크가 균일한 영역을 타일 단위로 보지 않고 건너뛰는 데 씀
+// 타일을 바꿀 때 setTile로 같이 갱신해야 함 (World::setTile / applyTileChanges가 함)
+class TileOccupancy
+{
+public:
+    static constexpr int kBlock = 8;
+
+    TileOccupancy() = default;
+    explicit TileOccupancy(const TileMap &map, int chunk_tiles = 32) { rebuild(map, chunk_tiles); }
+
+    void rebuild(const TileMap &map, int chunk_tiles = 32)
+    {
+        w_ = map.w;
+        h_ = map.h;
+        chunk_ = chunk_tiles;
+        cw_ = std::max(1, (map.w + chunk_ - 1) / chunk_);
+        ch_ = std::max(1, (map.h + chunk_ - 1) / chunk_);
+        bw_ = std::max(1, (map.w + kBlock - 1) / kBlock);
+        bh_ = std::max(1, (map.h + kBlock - 1) / kBlock);
+        walls_.assign(size_t(cw_) * ch_, 0);
+        blocks_.assign(size_t(bw_) * bh_, 0);
+        recountTiles(map, 0, 0, map.w, map.h);
+    }
+
+    // 타일 하나가 바뀐 뒤 호출
+    void setTile(int tx, int ty, bool was_wall, bool now_wall)
+    {
+        if (was_wall == now_wall)
+        {
+            return;
+        }
+        std::uint32_t &n = walls_[size_t(ty / chunk_) * cw_ + tx / chunk_];
+        n = now_wall ? n + 1 : n - 1;
+        blocks_[size_t(ty / kBlock) * bw_ + tx / kBlock] ^= bit(tx, ty);
+    }
+
+    // [x0, x1) x [y0, y1)에 걸친 청크와 블록을 다시 셈 (스냅샷 복원처럼 한꺼번에 바뀐 경우)
+    void recountTiles(const TileMap &map, int x0, int y0, int x1, int y1)
+    {
+        // 청크 경계로 넓혀서 (청크는 블록 크기의 배수라 블록도 통째로 덮음)
+        const int cx0 = std::max(0, x0 / chunk_), cx1 = std::min(cw_ - 1, (x1 - 1) / chunk_);
+        const int cy0 = std::max(0, y0 / chunk_), cy1 = std::min(ch_ - 1, (y1 - 1) / chunk_);
+        const int tx0 = cx0 * chunk_, tx1 = std::min(map.w, (cx1 + 1) * chunk_);
+        const int ty0 = cy0 * chunk_, ty1 = std::min(map.h, (cy1 + 1) * chunk_);
+        for (int by = ty0 / kBlock; by <= (ty1 - 1) / kBlock; ++by)
+        {
+            for (int bx = tx0 / kBlock; bx <= (tx1 - 1) / kBlock; ++bx)
+            {
+                blocks_[size_t(by) * bw_ + bx] = 0;
+            }
+        }
+        for (int cy = cy0; cy <= cy1; ++cy)
+        {
+            for (int cx = cx0; cx <= cx1; ++cx)
+            {
+                walls_[size_t(cy) * cw_ + cx] = 0;
+            }
+        }
+        for (int y = ty0; y < ty1; ++y)
+        {
+            const int *row = map.tiles.data() + size_t(y) * map.w;
+            for (int x = tx0; x < tx1; ++x)
+            {
+                if (row[x] == 1)
+                {
+                    ++walls_[size_t(y / chunk_) * cw_ + x / chunk_];
+                    blocks_[size_t(y / kBlock) * bw_ + x / kBlock] |= bit(x, y);
+                }
+            }
+        }
+    }
+
+    int chunkTiles() const { return chunk_; }
+    bool chunkEmpty(int cx, int cy) const { return walls_[size_t(cy) * cw_ + cx] == 0; }
+    std::uint32_t chunkWalls(int cx, int cy) const { return walls_[size_t(cy) * cw_ + cx]; }
+    TileFill chunkFill(int cx, int cy) const
+    {
+        const int ex = std::min(w_, (cx + 1) * chunk_), ey = std::min(h_, (cy + 1) * chunk_);
+        return fillOf(chunkWalls(cx, cy), std::uint32_t((ex - cx * chunk_) * (ey - cy * chunk_)));
+    }
+
+    // 블록 좌표 (타일 / kBlock)
+    std::uint64_t blockMask(int bx, int by) const { return blocks_[size_t(by) * bw_ + bx]; }
+    bool blockEmpty(int bx, int by) const { return blockMask(bx, by) == 0; }
+
+    // [x0, x1) x [y0, y1) 안에 벽이 있는지. 맵 밖은 보지 않음
+    bool anyWall(int x0, int y0, int x1, int y1) const
+    {
+        bool any = false;
+        forBlocks(x0, y0, x1, y1, [&](std::uint64_t bits, std::uint64_t) {
+            any = bits != 0;
+            return !any;
+        });
+        return any;
+    }
+
+    // [x0, x1) x [y0, y1)의 요약. 맵 밖은 잘라냄
+    TileFill fill(int x0, int y0, int x1, int y1) const
+    {
+        std::uint32_t walls = 0, tiles = 0;
+        bool mixed = false;
+        forBlocks(x0, y0, x1, y1, [&](std::uint64_t bits, std::uint64_t area) {
+            walls += std::uint32_t(std::popcount(bits));
+            tiles += std::uint32_t(std::popcount(area));
+            mixed = walls != 0 && walls != tiles;
+            return !mixed;
+        });
+        return mixed ? TileFill::Mixed : fillOf(walls, tiles);
+    }
+
+private:
+    static std::uint64_t bit(int x, int y) { return std::uint64_t(1) << ((y % kBlock) * kBlock + x % kBlock); }
+
+    static TileFill fillOf(std::uint32_t walls, std::uint32_t tiles)
+    {
+        return walls == 0 ? TileFill::Empty : (walls == tiles ? TileFill::Full : TileFill::Mixed);
+    }
+
+    // 블록의 [lo, hi) 열 x [lo, hi) 행 마스크
+    static std::uint64_t rectMask(int x0, int x1, int y0, int y1)
+    {
+        const std::uint64_t row = ((std::uint64_t(1) << (x1 - x0)) - 1) << x0; // x1 - x0 <= 8
+        std::uint64_t m = 0;
+        for (int y = y0; y < y1; ++y)
+        {
+            m |= row << (y * kBlock);
+        }
+        return m;
+    }
+
+    // fn(벽 비트 & 영역, 영역 비트) -> 계속할지
+    template <typename Fn>
+    void forBlocks(int x0, int y0, int x1, int y1, Fn &&fn) const
+    {
+        x0 = std::max(0, x0);
+        y0 = std::max(0, y0);
+        x1 = std::min(w_, x1);
+        y1 = std::min(h_, y1);
+        if (x0 >= x1 || y0 >= y1)
+        {
+            return;
+        }
+        for (int by = y0 / kBlock; by <= (y1 - 1) / kBlock; ++by)
+        {
+            const int ly0 = std::max(y0, by * kBlock) - by * kBlock;
+            const int ly1 = std::min(y1, (by + 1) * kBlock) - by * kBlock;
+            for (int bx = x0 / kBlock; bx <= (x1 - 1) / kBlock; ++bx)
+            {
+                const int lx0 = std::max(x0, bx * kBlock) - bx * kBlock;
+                const int lx1 = std::min(x1, (bx + 1) * kBlock) - bx * kBlock;
+                const std::uint64_t area = rectMask(lx0, lx1, ly0, ly1);
+                if (!fn(blocks_[size_t(by) * bw_ + bx] & area, area))
+                {
+                    return;
+                }
+            }
+        }
+    }
+
+private:
+    int w_{0}, h_{0};
+    int chunk_{32};
+    int cw_{0}, ch_{0};
+    int bw_{0}, bh_{0};
+    std::vector<std::uint32_t> walls_;
+    std::vector<std::uint64_t> blocks_;
+};
+} // namespace folio::world
@@ -1,8 +1,55 @@
 #include "tile_map.hpp"
 #include "src/geometry/types.hpp"
+#include <algorithm>
+#include <utility>
 
 namespace folio::world
 {
+void buildColliders(TileMap &map)
+{
+    map.colliders.clear();
+    for (int y = 0; y < map.h; ++y)
+    {
+        for (int x = 0; x < map.w; ++x)
+        {
+            if (map.tiles[y * map.w + x] == 1)
+            {
+                map.colliders.push_back(tileAABB(map, x, y));
+            }
+        }
+    }
+}
+
+void rebuildColliders(TileMap &map, int x0, int y0, int x1, int y1)
+{
+    x0 = std::max(0, x0);
+    y0 = std::max(0, y0);
+    x1 = std::min(map.w, x1);
+    y1 = std::min(map.h, y1);
+    const float ts = float(map.tile_size);
+    // colliders는 (y, x) 순서로 정렬되어 있으므로 행마다 [x0, x1) 구간만 바꿔 끼움
+    const auto before = [ts](const geometry::AABB &a, std::pair<int, int> yx) {
+        const int ay = int(a.y / ts), ax = int(a.x / ts);
+        return ay < yx.first || (ay == yx.first && ax < yx.second);
+    };
+    std::vector<geometry::AABB> row;
+    for (int y = y0; y < y1; ++y)
+    {
+        row.clear();
+        for (int x = x0; x < x1; ++x)
+        {
+            if (map.tiles[y * map.w + x] == 1)
+            {
+                row.push_back(tileAABB(map, x, y));
+            }
+        }
+        auto first = std::lower_bound(map.colliders.begin(), map.colliders.end(), std::pair{y, x0}, before);
+        auto last = std::lower_bound(first, map.colliders.end(), std::pair{y, x1}, before);
+        const auto at = map.colliders.erase(first, last);
+        map.colliders.insert(at, row.begin(), row.end());
+    }
+}
+
 TileMap fromASCII(const std::string &id, int tile_size, const std::vector<std::string> &rows)
 {
     TileMap map{};
@@ -17,14 +64,10 @@ TileMap fromASCII(const std::string &id, int tile_size, const std::vector<std::s
         for (int x = 0; x < map.w; ++x)
         {
             char c = rows[y][x];
-            int v = (c == '#') ? 1 : 0; // # 벽, . 바닥
-            map.tiles[y * map.w + x] = v;
-            if (v == 1)
-            {
-                map.colliders.push_back(geometry::AABB{float(x * tile_size), float(y * tile_size), float(tile_size), float(tile_size)});
-            }
+            map.tiles[y * map.w + x] = (c == '#') ? 1 : 0; // # 벽, . 바닥
         }
     }
+    buildColliders(map);
 
     return map;
 }
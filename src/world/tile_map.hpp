@@ -25,6 +25,12 @@ struct TileMap
     }
 };
 
+// 타일 하나를 value로 바꾸는 편집 (핫 리로드 diff 등)
+struct TileChange
+{
+    int x, y, value;
+};
+
 inline geometry::AABB boundsAABB(const TileMap &map)
 {
     return {0.f, 0.f, float(map.w * map.tile_size), float(map.h * map.tile_size)};
@@ -43,5 +49,10 @@ inline std::pair<int, int> worldToTile(const TileMap &map, float wx, float wy)
     return {tx, ty};
 }
 
+// 벽 타일마다 AABB를 만들어 map.colliders를 다시 채움 (행 우선 순서)
+void buildColliders(TileMap &map);
+// [x0, x1) x [y0, y1) 안의 콜라이더만 다시 만듦. 나머지는 그대로
+void rebuildColliders(TileMap &map, int x0, int y0, int x1, int y1);
+
 TileMap fromASCII(const std::string &id, int tile_size, const std::vector<std::string> &rows);
 }; // namespace folio::world
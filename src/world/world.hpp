@@ -1,14 +1,307 @@
 #pragma once
 
+#include "chunks.hpp"
+#include "lighting.hpp"
+#include "occupancy.hpp"
 #include "tile_map.hpp"
+#include "src/concurrency/job_system.hpp"
+#include "src/geometry/projection.hpp"
+#include "src/geometry/types.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
 #include <unordered_map>
+#include <vector>
 
 namespace folio::world
 {
-struct World
+// 맵 이름은 로드/전환 요청 같은 cold path에서만 쓰고, 이후로는 intern된 MapId로 접근
+using MapId = std::uint32_t;
+constexpr MapId kInvalidMap = ~MapId(0);
+
+// Projection은 모든 맵의 청크 캐시가 공유하는 투영 (geometry::TopDownProjection, IsoProjection 등)
+template <geometry::ScreenProjection Projection>
+class BasicWorld
 {
-    std::unordered_map<std::string, TileMap> maps{};
-    std::string current_map_id;
+public:
+    using Chunks = BasicChunkCache<Projection>;
+
+    BasicWorld() = default;
+    BasicWorld(const BasicWorld &) = delete;
+    BasicWorld &operator=(const BasicWorld &) = delete;
+    ~BasicWorld()
+    {
+        // 백그라운드 콜라이더 빌드가 맵을 참조하고 있으면 끝날 때까지 대기
+        while (inflight_.load(std::memory_order_acquire) > 0)
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    MapId intern(const std::string &name)
+    {
+        auto it = ids_.find(name);
+        if (it != ids_.end())
+        {
+            return it->second;
+        }
+        const MapId id = MapId(entries_.size());
+        ids_.emplace(name, id);
+        entries_.push_back(std::make_unique<Entry>());
+        return id;
+    }
+
+    MapId find(const std::string &name) const
+    {
+        auto it = ids_.find(name);
+        return it != ids_.end() ? it->second : kInvalidMap;
+    }
+
+    // map.id로 intern 후 상주시킴. 첫 맵은 현재 맵이 됨
+    // ambient: 광원이 닿지 않는 타일의 밝기 (255 = 조명 없음)
+    MapId add(TileMap map, int chunk_tiles = 32, std::uint8_t ambient = 255)
+    {
+        const Projection proj(map.tile_size);
+        return add(std::move(map), proj, chunk_tiles, ambient);
+    }
+
+    // 투영 파라미터를 직접 줄 때 (IsoDims를 바꾼 아이소 등). proj의 타일 크기는 맵과 같아야 함
+    MapId add(TileMap map, const Projection &proj, int chunk_tiles = 32, std::uint8_t ambient = 255)
+    {
+        assert(proj.tileSize() == map.tile_size && "projection tile size must match the map");
+        const MapId id = intern(map.id);
+        Entry &e = *entries_[id];
+        e.map = std::make_unique<TileMap>(std::move(map));
+        e.chunks = std::make_unique<Chunks>(*e.map, proj, chunk_tiles);
+        e.occupancy = std::make_unique<TileOccupancy>(*e.map, chunk_tiles);
+        e.lighting = std::make_unique<TileLighting>(*e.map, ambient);
+        e.chunks->setLighting(e.lighting.get());
+        e.chunks->setOccupancy(e.occupancy.get());
+        e.colliders_ready.store(!e.map->colliders.empty(), std::memory_order_release);
+        if (current_ == kInvalidMap)
+        {
+            current_ = id;
+        }
+        return id;
+    }
+
+    bool resident(MapId id) const { return id < entries_.size() && entries_[id]->map != nullptr; }
+
+    TileMap &map(MapId id) { return *entries_[id]->map; }
+    const TileMap &map(MapId id) const { return *entries_[id]->map; }
+    Chunks &chunks(MapId id) { return *entries_[id]->chunks; }
+    const Chunks &chunks(MapId id) const { return *entries_[id]->chunks; }
+    TileOccupancy &occupancy(MapId id) { return *entries_[id]->occupancy; }
+    const TileOccupancy &occupancy(MapId id) const { return *entries_[id]->occupancy; }
+    TileLighting &lighting(MapId id) { return *entries_[id]->lighting; }
+    const TileLighting &lighting(MapId id) const { return *entries_[id]->lighting; }
+
+    MapId current() const { return current_; }
+    TileMap &currentMap() { return map(current_); }
+    const TileMap &currentMap() const { return map(current_); }
+    Chunks &currentChunks() { return chunks(current_); }
+    const Chunks &currentChunks() const { return chunks(current_); }
+    TileOccupancy &currentOccupancy() { return occupancy(current_); }
+    const TileOccupancy &currentOccupancy() const { return occupancy(current_); }
+    TileLighting &currentLighting() { return lighting(current_); }
+
+    // 조명의 dirty 영역을 워커에서 다시 전파. 결과는 jobs.drain()에서 적용되고 바뀐 청크만 다시 구움
+    void updateLighting(MapId id, concurrency::JobSystem &jobs)
+    {
+        Entry &e = *entries_[id];
+        Chunks *chunks = e.chunks.get();
+        e.lighting->update(jobs, chunks->chunkTiles(), [chunks](int cx, int cy) { chunks->invalidateChunk(cx, cy); });
+    }
+
+    // 타일 하나를 바꾸고 occupancy, 청크 메쉬, 조명, 콜라이더를 같이 갱신. 바뀌었으면 true
+    // 타일을 직접 쓰면 occupancy 요약이 어긋나므로 편집은 이 함수나 applyTileChanges로
+    bool setTile(MapId id, int tx, int ty, int value)
+    {
+        Entry &e = *entries_[id];
+        TileMap &m = *e.map;
+        int &t = m.tiles[size_t(ty) * m.w + tx];
+        if (t == value)
+        {
+            return false;
+        }
+        e.occupancy->setTile(tx, ty, t == 1, value == 1);
+        t = value;
+        e.chunks->invalidateTile(tx, ty);
+        e.lighting->invalidateRegion(tx, ty, tx + 1, ty + 1);
+        if (e.colliders_ready.load(std::memory_order_acquire))
+        {
+            rebuildColliders(m, tx, ty, tx + 1, ty + 1);
+        }
+        return true;
+    }
+
+    // 타일 여러 개를 바꾸고 바뀐 청크의 메쉬, occupancy, 콜라이더만 갱신 (맵 핫 리로드 등)
+    // 바뀐 타일 수에 비례. 전환 중인 맵의 콜라이더를 백그라운드에서 만드는 중이면 안 됨
+    void applyTileChanges(MapId id, const std::vector<TileChange> &changes)
+    {
+        Entry &e = *entries_[id];
+        TileMap &m = *e.map;
+        const int ct = e.occupancy->chunkTiles();
+        const int cw = (m.w + ct - 1) / ct;
+        std::vector<int> dirty;
+        for (const TileChange &c : changes)
+        {
+            int &t = m.tiles[size_t(c.y) * m.w + c.x];
+            if (t == c.value)
+            {
+                continue;
+            }
+            e.occupancy->setTile(c.x, c.y, t == 1, c.value == 1);
+            t = c.value;
+            dirty.push_back((c.y / ct) * cw + c.x / ct);
+        }
+        std::sort(dirty.begin(), dirty.end());
+        dirty.erase(std::unique(dirty.begin(), dirty.end()), dirty.end());
+        for (const int d : dirty)
+        {
+            const int cx = d % cw, cy = d / cw;
+            e.chunks->invalidateChunk(cx, cy);
+            e.lighting->invalidateRegion(cx * ct, cy * ct, (cx + 1) * ct, (cy + 1) * ct);
+            if (e.colliders_ready.load(std::memory_order_acquire))
+            {
+                rebuildColliders(m, cx * ct, cy * ct, (cx + 1) * ct, (cy + 1) * ct);
+            }
+        }
+    }
+
+    // 즉시 교체 (스냅샷 복원 등). 진행 중인 전환은 취소됨
+    void setCurrent(MapId id)
+    {
+        if (resident(id))
+        {
+            current_ = id;
+            transition_ = Transition{};
+        }
+    }
+
+    // 맵 전환 시작: 목적지의 spawn 주변 청크와 콜라이더를 백그라운드로 준비
+    // 준비되는 동안 현재 맵은 그대로 돌아가고, 두 맵 모두 상주함
+    bool beginTransition(MapId to, const geometry::Vec2 &spawn, const sf::Vector2f &view_size, concurrency::JobSystem &jobs)
+    {
+        if (!resident(to) || to == current_ || transition_.target != kInvalidMap)
+        {
+            return false;
+        }
+        Entry &dst = *entries_[to];
+        transition_ = Transition{to, spawn, dst.chunks->viewAt(spawn, view_size)};
+        updateTransition(jobs);
+
+        if (!dst.colliders_ready.load(std::memory_order_acquire))
+        {
+            inflight_.fetch_add(1, std::memory_order_acq_rel);
+            jobs.dispatch([this, &dst]() {
+                buildColliders(*dst.map);
+                dst.colliders_ready.store(true, std::memory_order_release);
+                inflight_.fetch_sub(1, std::memory_order_acq_rel);
+            });
+        }
+        return true;
+    }
+
+    // 전환 중 매 프레임 호출: 목적지 조명을 먼저 전파하고, 그 뒤 화면 청크를 구움
+    // (조명 결과가 적용되면 구운 청크가 다시 무효화되므로 순서를 지킴. 무효화된 청크는 여기서 다시 요청됨)
+    void updateTransition(concurrency::JobSystem &jobs)
+    {
+        if (!transitioning())
+        {
+            return;
+        }
+        Entry &dst = *entries_[transition_.target];
+        if (dst.lighting->dirty() || dst.lighting->busy())
+        {
+            updateLighting(transition_.target, jobs);
+            return;
+        }
+        // 전환은 이 청크들을 기다리므로 Visible로 제출 (프레임 여유가 없을 때 GameLoop는 Visible만 진행시킴)
+        dst.chunks->prefetch(transition_.view, jobs, concurrency::Priority::Visible);
+    }
+
+    bool transitioning() const { return transition_.target != kInvalidMap; }
+    // 백그라운드 콜라이더 빌드가 맵 타일을 읽는 중인지
+    bool building() const { return inflight_.load(std::memory_order_acquire) > 0; }
+
+    // 백그라운드 콜라이더 빌드가 끝날 때까지 워커 큐를 도우며 대기 (타일을 통째로 바꾸기 전에)
+    void waitBuilds(concurrency::JobSystem &jobs) { jobs.waitFor(inflight_); }
+    MapId transitionTarget() const { return transition_.target; }
+    const geometry::Vec2 &transitionSpawn() const { return transition_.spawn; }
+
+    // 목적지의 조명, 화면 청크, 콜라이더가 모두 준비되었는지
+    bool transitionReady() const
+    {
+        if (!transitioning())
+        {
+            return false;
+        }
+        const Entry &dst = *entries_[transition_.target];
+        return dst.colliders_ready.load(std::memory_order_acquire) && !dst.lighting->dirty() &&
+               !dst.lighting->busy() && dst.chunks->ready(transition_.view);
+    }
+
+    // 준비가 끝났으면 현재 맵을 교체. 이전 맵과 캐시는 그대로 상주
+    bool commitTransition()
+    {
+        if (!transitionReady())
+        {
+            return false;
+        }
+        current_ = transition_.target;
+        transition_ = Transition{};
+        return true;
+    }
+
+    // 준비를 기다리며 지금 교체 (재생처럼 정해진 tick에 바꿔야 할 때). 남은 준비 작업을 여기서 처리함
+    bool completeTransition(concurrency::JobSystem &jobs)
+    {
+        if (!transitioning())
+        {
+            return false;
+        }
+        while (!transitionReady())
+        {
+            updateTransition(jobs);
+            jobs.drain(0.0, concurrency::Priority::Prefetch);
+            if (!jobs.runOne())
+            {
+                std::this_thread::yield();
+            }
+        }
+        return commitTransition();
+    }
+
+private:
+    struct Entry
+    {
+        std::unique_ptr<TileMap> map;
+        std::unique_ptr<Chunks> chunks;
+        std::unique_ptr<TileOccupancy> occupancy;
+        std::unique_ptr<TileLighting> lighting; // 맵과 청크보다 먼저 해제
+        std::atomic<bool> colliders_ready{false};
+    };
+
+    struct Transition
+    {
+        MapId target{kInvalidMap};
+        geometry::Vec2 spawn{};
+        sf::View view{};
+    };
+
+private:
+    std::unordered_map<std::string, MapId> ids_;
+    std::vector<std::unique_ptr<Entry>> entries_;
+    MapId current_{kInvalidMap};
+    Transition transition_{};
+    std::atomic<int> inflight_{0};
 };
 
+using World = BasicWorld<geometry::TopDownProjection>;
+using IsoWorld = BasicWorld<geometry::IsoProjection>;
 } // namespace folio::world